@@ -0,0 +1,114 @@
+// Intersection and shading kernels - per-shape local_intersect, intersect_world and lighting()
+
+#include <benchmark/benchmark.h>
+
+#include <ray_tracer_challenge/intersections.h>
+#include <ray_tracer_challenge/materials.h>
+#include <ray_tracer_challenge/patterns.h>
+#include <ray_tracer_challenge/planes.h>
+#include <ray_tracer_challenge/spheres.h>
+#include <ray_tracer_challenge/world.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+static void BM_local_intersect_sphere_hit(benchmark::State & state) {
+    auto const s = sphere(1);
+    auto r = ray(point(0.1, 0.2, -5.0), vector(0.0, 0.0, 1.0));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(local_intersect(s, r));
+    }
+}
+BENCHMARK(BM_local_intersect_sphere_hit);
+
+static void BM_local_intersect_sphere_miss(benchmark::State & state) {
+    auto const s = sphere(1);
+    auto r = ray(point(0.0, 2.0, -5.0), vector(0.0, 0.0, 1.0));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(local_intersect(s, r));
+    }
+}
+BENCHMARK(BM_local_intersect_sphere_miss);
+
+static void BM_local_intersect_plane(benchmark::State & state) {
+    auto const p = plane();
+    auto r = ray(point(0.0, 1.0, 0.0), vector(0.0, -1.0, 0.5));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(local_intersect(p, r));
+    }
+}
+BENCHMARK(BM_local_intersect_plane);
+
+// intersect() adds the transform of the ray into object space and the virtual call
+static void BM_intersect_transformed_sphere(benchmark::State & state) {
+    auto s = sphere(1);
+    s.set_transform(translation(0.5, 0.0, 0.0) * scaling(2.0, 2.0, 2.0));
+    Shape const & shape = s;
+    auto r = ray(point(0.1, 0.2, -5.0), vector(0.0, 0.0, 1.0));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(intersect(shape, r));
+    }
+}
+BENCHMARK(BM_intersect_transformed_sphere);
+
+static void BM_intersect_world(benchmark::State & state) {
+    auto const w = default_world();
+    auto r = ray(point(0.0, 0.0, -5.0), vector(0.0, 0.0, 1.0));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(intersect_world(w, r));
+    }
+}
+BENCHMARK(BM_intersect_world);
+
+static void BM_color_at(benchmark::State & state) {
+    auto const w = default_world();
+    auto r = ray(point(0.0, 0.0, -5.0), vector(0.0, 0.0, 1.0));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(color_at(w, r));
+    }
+}
+BENCHMARK(BM_color_at);
+
+static void BM_lighting(benchmark::State & state, bool in_shadow) {
+    auto const s = sphere(1);
+    auto const m = material();
+    auto const light = point_light(point(0.0, 10.0, -10.0), color(1.0, 1.0, 1.0));
+    auto p = point(0.0, 0.0, -1.0);
+    auto const eyev = vector(0.0, 0.0, -1.0);
+    auto const normalv = vector(0.0, 0.0, -1.0);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(p);
+        benchmark::DoNotOptimize(lighting(m, s, light, p, eyev, normalv, in_shadow));
+    }
+}
+BENCHMARK_CAPTURE(BM_lighting, lit, false);
+BENCHMARK_CAPTURE(BM_lighting, shadowed, true);
+
+static void BM_lighting_pattern(benchmark::State & state) {
+    auto const s = sphere(1);
+    auto m = material();
+    m.set_pattern(stripe_pattern(color(1.0, 1.0, 1.0), color(0.0, 0.0, 0.0)));
+    auto const light = point_light(point(0.0, 10.0, -10.0), color(1.0, 1.0, 1.0));
+    auto p = point(0.0, 0.0, -1.0);
+    auto const eyev = vector(0.0, 0.0, -1.0);
+    auto const normalv = vector(0.0, 0.0, -1.0);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(p);
+        benchmark::DoNotOptimize(lighting(m, s, light, p, eyev, normalv, false));
+    }
+}
+BENCHMARK(BM_lighting_pattern);
@@ -0,0 +1,143 @@
+// Core math kernels - tuple arithmetic and 4x4 matrix operations
+
+#include <benchmark/benchmark.h>
+
+#include <ray_tracer_challenge/matrices.h>
+#include <ray_tracer_challenge/transformations.h>
+#include <ray_tracer_challenge/tuples.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+// A typical object transform: translate * rotate * scale, invertible
+Matrix<4> make_transform() {
+    return translation(1.0, -2.0, 3.5) * rotation_y(0.7) * rotation_x(-0.3) * scaling(2.0, 0.5, 1.5);
+}
+
+} // namespace
+
+static void BM_tuple_add(benchmark::State & state) {
+    auto a = vector(1.0, 2.0, 3.0);
+    auto b = vector(-0.5, 0.25, 4.0);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a + b);
+    }
+}
+BENCHMARK(BM_tuple_add);
+
+static void BM_tuple_scale(benchmark::State & state) {
+    auto a = vector(1.0, 2.0, 3.0);
+    fp_t s {1.5};
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(s);
+        benchmark::DoNotOptimize(a * s);
+    }
+}
+BENCHMARK(BM_tuple_scale);
+
+static void BM_tuple_dot(benchmark::State & state) {
+    auto a = vector(1.0, 2.0, 3.0);
+    auto b = vector(-0.5, 0.25, 4.0);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(dot(a, b));
+    }
+}
+BENCHMARK(BM_tuple_dot);
+
+static void BM_tuple_cross(benchmark::State & state) {
+    auto a = vector(1.0, 2.0, 3.0);
+    auto b = vector(-0.5, 0.25, 4.0);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(cross(a, b));
+    }
+}
+BENCHMARK(BM_tuple_cross);
+
+static void BM_tuple_normalize(benchmark::State & state) {
+    auto a = vector(1.0, 2.0, 3.0);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(normalize(a));
+    }
+}
+BENCHMARK(BM_tuple_normalize);
+
+static void BM_tuple_reflect(benchmark::State & state) {
+    auto in = vector(1.0, -1.0, 0.0);
+    auto n = normalize(vector(0.0, 1.0, 0.2));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(in);
+        benchmark::DoNotOptimize(n);
+        benchmark::DoNotOptimize(reflect(in, n));
+    }
+}
+BENCHMARK(BM_tuple_reflect);
+
+static void BM_matrix4_multiply(benchmark::State & state) {
+    auto a = make_transform();
+    auto b = rotation_z(0.4) * translation(0.0, 1.0, 0.0);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(a * b);
+    }
+}
+BENCHMARK(BM_matrix4_multiply);
+
+static void BM_matrix4_multiply_tuple(benchmark::State & state) {
+    auto m = make_transform();
+    auto p = point(0.5, -1.0, 2.0);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m);
+        benchmark::DoNotOptimize(p);
+        benchmark::DoNotOptimize(m * p);
+    }
+}
+BENCHMARK(BM_matrix4_multiply_tuple);
+
+static void BM_matrix4_transpose(benchmark::State & state) {
+    auto m = make_transform();
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m);
+        benchmark::DoNotOptimize(transpose(m));
+    }
+}
+BENCHMARK(BM_matrix4_transpose);
+
+static void BM_matrix4_determinant(benchmark::State & state) {
+    auto m = make_transform();
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m);
+        benchmark::DoNotOptimize(determinant(m));
+    }
+}
+BENCHMARK(BM_matrix4_determinant);
+
+static void BM_matrix4_inverse(benchmark::State & state) {
+    auto m = make_transform();
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m);
+        benchmark::DoNotOptimize(inverse(m));
+    }
+}
+BENCHMARK(BM_matrix4_inverse);
@@ -0,0 +1,91 @@
+// Precomputed Perlin Noise volume - speed vs error
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+#include <ray_tracer_challenge/noise_volume.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+constexpr int PERIOD {8};
+constexpr int OCTAVES {4};
+constexpr fp_t PERSISTENCE {0.9};
+constexpr std::size_t NUM_POINTS {4096};
+
+struct Points {
+    Points() {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            xs.push_back(0.00193 * static_cast<double>(i));
+            ys.push_back(PERIOD - 0.00171 * static_cast<double>(i));
+            zs.push_back(0.5 + 0.00029 * static_cast<double>(i % 97));
+        }
+    }
+
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<double> zs;
+};
+
+} // namespace
+
+// Direct evaluation, for reference
+static void BM_noise_volume_reference(benchmark::State & state) {
+    auto const pn = perlin_noise(PERIOD);
+    Points const p;
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            benchmark::DoNotOptimize(pn.octave_perlin(p.xs[i], p.ys[i], p.zs[i], OCTAVES, PERSISTENCE));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+BENCHMARK(BM_noise_volume_reference);
+
+// Lookup cost at each resolution, with the RMS and maximum error against the
+// direct evaluation reported as counters
+static void BM_noise_volume_sample(benchmark::State & state) {
+    auto const resolution = static_cast<unsigned int>(state.range(0));
+    auto const volume = noise_volume(PERIOD, resolution, OCTAVES, PERSISTENCE);
+    Points const p;
+    {
+        // The counters stop here, before the error check below
+        BenchmarkPerfCounters const perf {state};
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+                benchmark::DoNotOptimize(volume.sample(p.xs[i], p.ys[i], p.zs[i]));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+
+    auto const pn = perlin_noise(PERIOD);
+    fp_t sum_squares {0};
+    fp_t max_error {0};
+    for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+        auto const error = std::abs(volume.sample(p.xs[i], p.ys[i], p.zs[i])
+                                    - pn.octave_perlin(p.xs[i], p.ys[i], p.zs[i], OCTAVES, PERSISTENCE));
+        sum_squares += error * error;
+        max_error = std::max(max_error, error);
+    }
+    state.counters["rms_error"] = std::sqrt(sum_squares / NUM_POINTS);
+    state.counters["max_error"] = max_error;
+    state.counters["bytes"] = static_cast<double>(resolution) * resolution * resolution * sizeof(float);
+}
+BENCHMARK(BM_noise_volume_sample)->Arg(64)->Arg(128)->Arg(256);
+
+// One-off cost of baking
+static void BM_noise_volume_bake(benchmark::State & state) {
+    auto const resolution = static_cast<unsigned int>(state.range(0));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        auto const volume = noise_volume(PERIOD, resolution, OCTAVES, PERSISTENCE);
+        benchmark::DoNotOptimize(&volume);
+    }
+}
+BENCHMARK(BM_noise_volume_bake)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,97 @@
+// Patterns - pattern_at() for every pattern type
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include <ray_tracer_challenge/patterns.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+constexpr std::size_t NUM_POINTS {1024};
+
+// Points spread across several stripes, rings and checkers, so that the
+// branches in the patterns are not perfectly predictable
+std::vector<Point> make_points() {
+    std::vector<Point> points;
+    points.reserve(NUM_POINTS);
+    for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+        auto const t = static_cast<fp_t>(i);
+        points.push_back(point(0.0137 * t - 5.0, 0.0071 * t - 3.0, 0.0029 * static_cast<fp_t>(i % 97) - 0.1));
+    }
+    return points;
+}
+
+auto const WHITE = color(1.0, 1.0, 1.0);
+auto const BLACK = color(0.0, 0.0, 0.0);
+
+} // namespace
+
+static void run_pattern(benchmark::State & state, Pattern const & pattern) {
+    auto const points = make_points();
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        for (auto const & p: points) {
+            benchmark::DoNotOptimize(pattern.pattern_at(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+
+static void BM_pattern_solid(benchmark::State & state) {
+    run_pattern(state, SolidPattern {WHITE});
+}
+BENCHMARK(BM_pattern_solid);
+
+static void BM_pattern_stripe(benchmark::State & state) {
+    run_pattern(state, stripe_pattern(WHITE, BLACK));
+}
+BENCHMARK(BM_pattern_stripe);
+
+static void BM_pattern_gradient(benchmark::State & state) {
+    run_pattern(state, gradient_pattern(WHITE, BLACK));
+}
+BENCHMARK(BM_pattern_gradient);
+
+static void BM_pattern_ring(benchmark::State & state) {
+    run_pattern(state, ring_pattern(WHITE, BLACK));
+}
+BENCHMARK(BM_pattern_ring);
+
+static void BM_pattern_checkers(benchmark::State & state) {
+    run_pattern(state, checkers_pattern(WHITE, BLACK));
+}
+BENCHMARK(BM_pattern_checkers);
+
+static void BM_pattern_radial_gradient(benchmark::State & state) {
+    run_pattern(state, radial_gradient_pattern(WHITE, BLACK));
+}
+BENCHMARK(BM_pattern_radial_gradient);
+
+static void BM_pattern_blended(benchmark::State & state) {
+    run_pattern(state, blended_pattern(stripe_pattern(WHITE, BLACK),
+                                       stripe_pattern(BLACK, WHITE)));
+}
+BENCHMARK(BM_pattern_blended);
+
+// Nested patterns pay for a virtual call and a transform per level
+static void BM_pattern_nested(benchmark::State & state) {
+    run_pattern(state, checkers_pattern(stripe_pattern(WHITE, BLACK),
+                                        ring_pattern(BLACK, WHITE)));
+}
+BENCHMARK(BM_pattern_nested);
+
+static void BM_pattern_perturbed(benchmark::State & state) {
+    auto const octaves = static_cast<int>(state.range(0));
+    run_pattern(state, perturbed_pattern(stripe_pattern(WHITE, BLACK), 0.5, octaves));
+}
+BENCHMARK(BM_pattern_perturbed)->Arg(1)->Arg(4);
+
+static void BM_pattern_perturbed_simplex(benchmark::State & state) {
+    auto const octaves = static_cast<int>(state.range(0));
+    run_pattern(state, perturbed_pattern(stripe_pattern(WHITE, BLACK), 0.5, octaves, 0.9, NoiseType::simplex));
+}
+BENCHMARK(BM_pattern_perturbed_simplex)->Arg(1)->Arg(4);
@@ -0,0 +1,132 @@
+// Perlin Noise - scalar vs batch evaluation
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include <ray_tracer_challenge/perlin_noise.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+constexpr std::size_t NUM_POINTS {4096};
+
+template <typename T>
+struct Points {
+    Points() {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            xs.push_back(static_cast<T>(0.0137 * static_cast<double>(i)));
+            ys.push_back(static_cast<T>(3.0 - 0.0071 * static_cast<double>(i)));
+            zs.push_back(static_cast<T>(0.5 + 0.0029 * static_cast<double>(i % 97)));
+        }
+        out.resize(NUM_POINTS);
+    }
+
+    std::vector<T> xs;
+    std::vector<T> ys;
+    std::vector<T> zs;
+    std::vector<T> out;
+};
+
+} // namespace
+
+static void BM_perlin_scalar(benchmark::State & state) {
+    auto const pn = perlin_noise();
+    Points<double> p;
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            p.out[i] = pn.perlin(p.xs[i], p.ys[i], p.zs[i]);
+        }
+        benchmark::DoNotOptimize(p.out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+BENCHMARK(BM_perlin_scalar);
+
+template <unsigned int Lanes, typename T>
+static void BM_perlin_batch(benchmark::State & state) {
+    auto const pn = perlin_noise();
+    Points<T> p;
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        pn.perlin_batch<Lanes>(p.xs.data(), p.ys.data(), p.zs.data(), p.out.data(), NUM_POINTS);
+        benchmark::DoNotOptimize(p.out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+BENCHMARK(BM_perlin_batch<4, double>);
+BENCHMARK(BM_perlin_batch<8, double>);
+BENCHMARK(BM_perlin_batch<16, double>);
+BENCHMARK(BM_perlin_batch<4, float>);
+BENCHMARK(BM_perlin_batch<8, float>);
+BENCHMARK(BM_perlin_batch<16, float>);
+
+static void BM_octave_perlin_scalar(benchmark::State & state) {
+    auto const pn = perlin_noise();
+    auto const octaves = static_cast<int>(state.range(0));
+    Points<double> p;
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            p.out[i] = pn.octave_perlin(p.xs[i], p.ys[i], p.zs[i], octaves, 0.9);
+        }
+        benchmark::DoNotOptimize(p.out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+BENCHMARK(BM_octave_perlin_scalar)->Arg(1)->Arg(4);
+
+template <unsigned int Lanes, typename T>
+static void BM_octave_perlin_batch(benchmark::State & state) {
+    auto const pn = perlin_noise();
+    auto const octaves = static_cast<int>(state.range(0));
+    Points<T> p;
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        pn.octave_perlin_batch<Lanes>(p.xs.data(), p.ys.data(), p.zs.data(), p.out.data(), NUM_POINTS,
+                                      octaves, T(0.9));
+        benchmark::DoNotOptimize(p.out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+BENCHMARK(BM_octave_perlin_batch<8, double>)->Arg(1)->Arg(4);
+BENCHMARK(BM_octave_perlin_batch<8, float>)->Arg(1)->Arg(4);
+
+// The three perturbation components used by PerturbedPattern, as separate calls
+static void BM_octave_perlin_three_calls(benchmark::State & state) {
+    auto const pn = perlin_noise();
+    auto const octaves = static_cast<int>(state.range(0));
+    Points<double> p;
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            auto const a = pn.octave_perlin(p.xs[i], p.ys[i], p.zs[i], octaves, 0.9);
+            auto const b = pn.octave_perlin(p.xs[i], p.ys[i], p.zs[i] + 1.0, octaves, 0.9);
+            auto const c = pn.octave_perlin(p.xs[i], p.ys[i], p.zs[i] + 2.0, octaves, 0.9);
+            p.out[i] = a + b + c;
+        }
+        benchmark::DoNotOptimize(p.out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+BENCHMARK(BM_octave_perlin_three_calls)->Arg(1)->Arg(4);
+
+// The three perturbation components used by PerturbedPattern, fused
+static void BM_octave_perlin3(benchmark::State & state) {
+    auto const pn = perlin_noise();
+    auto const octaves = static_cast<int>(state.range(0));
+    Points<double> p;
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            auto const n = pn.octave_perlin3(p.xs[i], p.ys[i], p.zs[i], octaves, 0.9);
+            p.out[i] = n[0] + n[1] + n[2];
+        }
+        benchmark::DoNotOptimize(p.out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+BENCHMARK(BM_octave_perlin3)->Arg(1)->Arg(4);
@@ -0,0 +1,66 @@
+// Compact pixel types - conversion throughput
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <ray_tracer_challenge/pixels.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+constexpr std::size_t NUM_PIXELS {1 << 16};
+
+std::vector<Color> make_colors() {
+    std::vector<Color> colors;
+    colors.reserve(NUM_PIXELS);
+    for (std::size_t i = 0; i < NUM_PIXELS; ++i) {
+        colors.push_back(color(static_cast<double>(i % 256) / 200.0,
+                               static_cast<double>(i % 97) / 97.0,
+                               static_cast<double>(i % 13) * 0.3));
+    }
+    return colors;
+}
+
+template <typename PixelType>
+void BM_from_color(benchmark::State & state) {
+    auto const colors = make_colors();
+    std::vector<PixelType> pixels(colors.size());
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        convert_pixels<PixelType, Color>(colors, pixels);
+        benchmark::DoNotOptimize(pixels.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pixels.size()));
+    state.counters["bytes_per_pixel"] = sizeof(PixelType);
+}
+
+template <typename PixelType>
+void BM_to_color(benchmark::State & state) {
+    auto const colors = make_colors();
+    std::vector<PixelType> pixels(colors.size());
+    convert_pixels<PixelType, Color>(colors, pixels);
+    std::vector<Color> out(colors.size());
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        convert_pixels<Color, PixelType>(pixels, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pixels.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_from_color<Rgb32f>);
+BENCHMARK(BM_from_color<Rgb16f>);
+BENCHMARK(BM_from_color<Rgbe>);
+BENCHMARK(BM_from_color<Srgb8>);
+BENCHMARK(BM_to_color<Rgb32f>);
+BENCHMARK(BM_to_color<Rgb16f>);
+BENCHMARK(BM_to_color<Rgbe>);
+BENCHMARK(BM_to_color<Srgb8>);
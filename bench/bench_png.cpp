@@ -0,0 +1,68 @@
+// PNG image output - compared with the PPM path
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <thread>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/png.h>
+#include <ray_tracer_challenge/ppm.h>
+#include <ray_tracer_challenge/thread_pool.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+auto make_canvas(unsigned int width, unsigned int height) {
+    auto c = canvas(width, height);
+    for (auto y = 0U; y < height; ++y) {
+        for (auto x = 0U; x < width; ++x) {
+            c.write_pixel(x, y, color(static_cast<double>(x) / width,
+                                      static_cast<double>(y) / height,
+                                      (x / 16 + y / 16) % 2 ? 0.8 : 0.2));
+        }
+    }
+    return c;
+}
+
+void set_counters(benchmark::State & state, Canvas<Color> const & c, std::size_t bytes) {
+    state.counters["Mpixels/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * c.width() * c.height() / 1e6,
+                                                     benchmark::Counter::kIsRate);
+    state.counters["file_bytes"] = static_cast<double>(bytes);
+}
+
+} // namespace
+
+// The PPM text that the chapter programs write, for comparison
+static void BM_encode_ppm_p3(benchmark::State & state) {
+    auto const c = make_canvas(2048, 1536);
+    std::size_t bytes {};
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        std::ostringstream os;
+        write_ppm(os, c);
+        bytes = os.tellp();
+    }
+    set_counters(state, c, bytes);
+}
+BENCHMARK(BM_encode_ppm_p3)->Unit(benchmark::kMillisecond);
+
+// PNG, with bands compressed on a pool of `threads` workers (0: calling thread)
+static void BM_encode_png(benchmark::State & state) {
+    auto const c = make_canvas(2048, 1536);
+    auto const threads = static_cast<unsigned int>(state.range(0));
+    // Count before starting the pool, so its threads are counted too
+    BenchmarkPerfCounters const perf {state};
+    std::unique_ptr<ThreadPool> pool {threads > 0 ? std::make_unique<ThreadPool>(threads) : nullptr};
+    std::size_t bytes {};
+    for (auto _ : state) {
+        std::ostringstream os;
+        write_png(os, c, pool.get());
+        bytes = os.tellp();
+    }
+    set_counters(state, c, bytes);
+}
+BENCHMARK(BM_encode_png)->Arg(0)->Arg(2)->Arg(std::thread::hardware_concurrency())
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
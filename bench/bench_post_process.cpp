@@ -0,0 +1,78 @@
+// Post-processing - throughput in megapixels per second
+
+#include <benchmark/benchmark.h>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/post_process.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+constexpr unsigned int WIDTH {1920};
+constexpr unsigned int HEIGHT {1080};
+
+template <typename PixelType>
+auto make_canvas() {
+    auto c = canvas<PixelType>(WIDTH, HEIGHT);
+    for (auto y = 0U; y < HEIGHT; ++y) {
+        for (auto x = 0U; x < WIDTH; ++x) {
+            write_pixel(c, x, y, to_pixel<PixelType>(color(2.0 * x / WIDTH, 1.5 * y / HEIGHT, 0.5)));
+        }
+    }
+    return c;
+}
+
+void set_mpixels(benchmark::State & state) {
+    state.counters["Mpixels/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * WIDTH * HEIGHT / 1e6,
+                                                     benchmark::Counter::kIsRate);
+}
+
+// Arguments: tone map, sRGB, dither, threads
+template <typename PixelType>
+void BM_post_process(benchmark::State & state) {
+    auto const c = make_canvas<PixelType>();
+    PostProcessOptions options;
+    options.tone_map = static_cast<ToneMap>(state.range(0));
+    options.srgb = state.range(1) != 0;
+    options.dither = state.range(2) != 0;
+    options.threads = static_cast<unsigned int>(state.range(3));
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        auto out = post_process(c, options);
+        benchmark::DoNotOptimize(out);
+    }
+    set_mpixels(state);
+}
+
+// Baseline: the per-channel clamp and rint used by the writers
+void BM_quantize_channel(benchmark::State & state) {
+    auto const c = make_canvas<Color>();
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        auto out = convert_canvas<Rgb8>(c);
+        benchmark::DoNotOptimize(out);
+    }
+    set_mpixels(state);
+}
+
+} // namespace
+
+BENCHMARK(BM_quantize_channel)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_post_process<Color>)
+    ->ArgNames({"tone_map", "srgb", "dither", "threads"})
+    ->Args({0, 0, 0, 1})
+    ->Args({0, 1, 0, 1})
+    ->Args({2, 1, 1, 1})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_post_process<Rgb32f>)
+    ->ArgNames({"tone_map", "srgb", "dither", "threads"})
+    ->Args({0, 0, 0, 1})
+    ->Args({0, 1, 0, 1})
+    ->Args({1, 1, 1, 1})
+    ->Args({2, 1, 1, 1})
+    ->Args({3, 1, 1, 1})
+    ->Args({2, 1, 1, 2})
+    ->Args({2, 1, 1, 4})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,122 @@
+// PPM image output - encode throughput
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/ppm.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+auto make_canvas(unsigned int width, unsigned int height) {
+    auto c = canvas(width, height);
+    for (auto y = 0U; y < height; ++y) {
+        for (auto x = 0U; x < width; ++x) {
+            c.write_pixel(x, y, color(static_cast<double>(x) / width,
+                                      static_cast<double>(y) / height,
+                                      0.5));
+        }
+    }
+    return c;
+}
+
+// The original ppm_from_canvas(), kept as a baseline for comparison
+namespace legacy {
+
+inline void add_value(std::string & row, double value) {
+    const auto v = std::min(std::max(value, 0.0), 1.0);
+    const unsigned int ivalue = std::rint(v * 255);
+    if (!row.empty()) {
+        row += ' ';
+    }
+    row += std::to_string(ivalue);
+}
+
+inline void split_line_by(std::vector<std::string> & lines,
+                          std::string_view line, int limit) {
+    if (line.length() > 70) {
+        const auto idx = line.rfind(' ', 70 - 1);
+        lines.emplace_back(line.substr(0, idx));
+        line = line.substr(idx + 1);
+        split_line_by(lines, line, limit);
+    } else {
+        lines.emplace_back(line);
+    }
+}
+
+template <typename Canvas>
+auto ppm_from_canvas(Canvas const & canvas) {
+    const auto header = (boost::format("P3\n%1% %2%\n255\n") % canvas.width() % canvas.height()).str();
+
+    std::string data;
+
+    for (auto y = 0U; y < canvas.height(); ++y) {
+        std::string row;
+        for (auto x = 0U; x < canvas.width(); ++x) {
+            const auto p = canvas.pixel_at(x, y);
+
+            add_value(row, p->red());
+            add_value(row, p->green());
+            add_value(row, p->blue());
+        }
+
+        std::vector<std::string> lines;
+        split_line_by(lines, row, 70);
+
+        for (auto & i : lines) {
+            data += i + '\n';
+        }
+    }
+
+    return header + data;
+}
+
+} // namespace legacy
+
+// Discards everything written to it, so only the encoding is measured
+class NullBuffer : public std::streambuf {
+protected:
+    std::streamsize xsputn(char const *, std::streamsize n) override { return n; }
+    int overflow(int c) override { return c; }
+};
+
+} // namespace
+
+static void BM_ppm_legacy_p3_string(benchmark::State & state) {
+    auto const c = make_canvas(state.range(0), state.range(1));
+    std::size_t bytes {};
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        auto const ppm = legacy::ppm_from_canvas(c);
+        bytes = ppm.size();
+        benchmark::DoNotOptimize(ppm.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["Mpixels/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * c.width() * c.height() / 1e6,
+                                                     benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ppm_legacy_p3_string)->Args({512, 384})->Args({2048, 1536})->Unit(benchmark::kMillisecond);
+
+static void BM_ppm_stream(benchmark::State & state, PpmFormat format) {
+    auto const c = make_canvas(state.range(0), state.range(1));
+    NullBuffer null_buffer;
+    std::ostream os {&null_buffer};
+    auto const bytes = ppm_from_canvas(c, format).size();
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        write_ppm(os, c, format);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["Mpixels/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * c.width() * c.height() / 1e6,
+                                                     benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_ppm_stream, p3, PpmFormat::p3)->Args({512, 384})->Args({2048, 1536})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ppm_stream, p6, PpmFormat::p6)->Args({512, 384})->Args({2048, 1536})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,130 @@
+// Rendering - serial versus parallel tiled, row-order versus tiled canvas
+
+#include <benchmark/benchmark.h>
+
+#include <numbers>
+
+#include <ray_tracer_challenge/camera.h>
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/world.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+using std::numbers::pi;
+
+namespace {
+
+constexpr unsigned int WIDTH {160};
+constexpr unsigned int HEIGHT {90};
+
+// The chapter 7 scene: three spheres in a room made of flattened spheres
+World make_world() {
+    auto w = world();
+
+    auto floor = sphere(1);
+    floor.set_transform(scaling(10.0, 0.01, 10.0));
+    floor.material().set_color(color(1.0, 0.9, 0.9));
+    floor.material().set_specular(0.0);
+
+    auto left_wall = sphere(2);
+    left_wall.set_transform(translation(0.0, 0.0, 5.0) * rotation_y(-pi / 4.0) * rotation_x(pi / 2.0) *
+                            scaling(10.0, 0.01, 10.0));
+    left_wall.material() = floor.material();
+
+    auto right_wall = sphere(3);
+    right_wall.set_transform(translation(0.0, 0.0, 5.0) * rotation_y(pi / 4.0) * rotation_x(pi / 2.0) *
+                             scaling(10.0, 0.01, 10.0));
+    right_wall.material() = floor.material();
+
+    auto middle = sphere(4);
+    middle.set_transform(translation(-0.5, 1.0, 0.5));
+    middle.material().set_color(color(0.1, 1.0, 0.5));
+    middle.material().set_diffuse(0.7);
+    middle.material().set_specular(0.3);
+
+    auto right = sphere(5);
+    right.set_transform(translation(1.5, 0.5, -0.5) * scaling(0.5, 0.5, 0.5));
+    right.material().set_color(color(0.5, 1.0, 0.1));
+    right.material().set_diffuse(0.7);
+    right.material().set_specular(0.3);
+
+    auto left = sphere(6);
+    left.set_transform(translation(-1.5, 0.33, -0.75) * scaling(0.33, 0.33, 0.33));
+    left.material().set_color(color(1.0, 0.8, 0.1));
+    left.material().set_diffuse(0.7);
+    left.material().set_specular(0.3);
+
+    w.add_object(floor);
+    w.add_object(left_wall);
+    w.add_object(right_wall);
+    w.add_object(middle);
+    w.add_object(right);
+    w.add_object(left);
+    w.add_light(point_light(point(-10.0, 10.0, -10.0), color(1.0, 1.0, 1.0)));
+    return w;
+}
+
+Camera make_camera() {
+    auto cam = camera(WIDTH, HEIGHT, pi / 3.0);
+    cam.set_transform(view_transform(point(0.0, 1.5, -5.0), point(0.0, 1.0, 0.0), vector(0.0, 1.0, 0.0)));
+    return cam;
+}
+
+void set_pixels_processed(benchmark::State & state) {
+    state.SetItemsProcessed(state.iterations() * WIDTH * HEIGHT);
+}
+
+void BM_render_serial(benchmark::State & state) {
+    auto const w = make_world();
+    auto const cam = make_camera();
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        auto image = render(cam, w);
+        benchmark::DoNotOptimize(image);
+    }
+    set_pixels_processed(state);
+}
+
+// Arguments: number of threads
+void BM_render_tiles_row_canvas(benchmark::State & state) {
+    auto const w = make_world();
+    auto const cam = make_camera();
+    auto image = canvas(WIDTH, HEIGHT);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        render(cam, w, image, RenderOptions {static_cast<unsigned int>(state.range(0)), 32});
+        benchmark::ClobberMemory();
+    }
+    set_pixels_processed(state);
+}
+
+// Arguments: number of threads
+void BM_render_tiles_tiled_canvas(benchmark::State & state) {
+    auto const w = make_world();
+    auto const cam = make_camera();
+    auto image = tiled_canvas<Color, 32>(WIDTH, HEIGHT);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        render(cam, w, image, RenderOptions {static_cast<unsigned int>(state.range(0)), 32});
+        benchmark::ClobberMemory();
+    }
+    set_pixels_processed(state);
+}
+
+void BM_linearize(benchmark::State & state) {
+    auto const image = tiled_canvas<Color, 32>(1920, 1080);
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        auto linear = linearize(image);
+        benchmark::DoNotOptimize(linear);
+    }
+    state.SetItemsProcessed(state.iterations() * 1920 * 1080);
+}
+
+} // namespace
+
+BENCHMARK(BM_render_serial)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_render_tiles_row_canvas)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_render_tiles_tiled_canvas)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_linearize)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,73 @@
+// Simplex Noise - per-sample cost compared with Perlin Noise
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include <ray_tracer_challenge/perlin_noise.h>
+#include <ray_tracer_challenge/simplex_noise.h>
+#include "support/perf_counters.h"
+
+using namespace rtc;
+
+namespace {
+
+constexpr std::size_t NUM_POINTS {4096};
+
+struct Points {
+    Points() {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            xs.push_back(0.0137 * static_cast<double>(i));
+            ys.push_back(3.0 - 0.0071 * static_cast<double>(i));
+            zs.push_back(0.5 + 0.0029 * static_cast<double>(i % 97));
+        }
+    }
+
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<double> zs;
+};
+
+} // namespace
+
+template <typename Noise, typename Fn>
+static void run_noise(benchmark::State & state, Noise const & noise, Fn fn) {
+    Points const p;
+    BenchmarkPerfCounters const perf {state};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+            benchmark::DoNotOptimize(fn(noise, p.xs[i], p.ys[i], p.zs[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+
+static void BM_noise_perlin(benchmark::State & state) {
+    run_noise(state, perlin_noise(), [](auto const & n, double x, double y, double z) {
+        return n.perlin(x, y, z);
+    });
+}
+BENCHMARK(BM_noise_perlin);
+
+static void BM_noise_simplex(benchmark::State & state) {
+    run_noise(state, simplex_noise(), [](auto const & n, double x, double y, double z) {
+        return n.simplex(x, y, z);
+    });
+}
+BENCHMARK(BM_noise_simplex);
+
+static void BM_noise_octave_perlin(benchmark::State & state) {
+    auto const octaves = static_cast<int>(state.range(0));
+    run_noise(state, perlin_noise(), [octaves](auto const & n, double x, double y, double z) {
+        return n.octave_perlin(x, y, z, octaves, 0.9);
+    });
+}
+BENCHMARK(BM_noise_octave_perlin)->Arg(4);
+
+static void BM_noise_octave_simplex(benchmark::State & state) {
+    auto const octaves = static_cast<int>(state.range(0));
+    run_noise(state, simplex_noise(), [octaves](auto const & n, double x, double y, double z) {
+        return n.octave_simplex(x, y, z, octaves, 0.9);
+    });
+}
+BENCHMARK(BM_noise_octave_simplex)->Arg(4);
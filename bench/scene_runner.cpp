@@ -0,0 +1,299 @@
+// Scene benchmark runner
+//
+// Renders the chapter scenes (see scenes.h) at fixed sizes and thread counts,
+// and reports the wall time, rays per second and peak resident set size of
+// each.  Rays are counted by the renderer in builds with RTC_ENABLE_STATS
+// (primary plus shadow rays); otherwise only primary rays are counted.  Each
+// case runs in its own child process, so its peak RSS is its own and not the
+// high-water mark of everything before it.
+//
+// Results can be saved as JSON, and compared against a previously saved
+// baseline: any case slower than the baseline by more than the threshold is a
+// regression, and the runner exits with status 1.
+//
+//   RayTracerChallengeSceneRunner [--scenes=<regex>] [--sizes=160x120,320x240]
+//                                 [--threads=1,0] [--repetitions=3]
+//                                 [--out=<file>] [--baseline=<file>] [--threshold=0.1]
+//
+// A thread count of 0 means one per hardware thread.  Wall time is the fastest
+// of the repetitions.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/format.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/scenes.h>
+
+using namespace rtc;
+
+namespace {
+
+struct Size {
+    unsigned int width {};
+    unsigned int height {};
+};
+
+struct Options {
+    std::string scenes {"."};
+    std::vector<Size> sizes {{160, 120}, {320, 240}};
+    std::vector<unsigned int> threads {1, 0};
+    unsigned int repetitions {3};
+    std::string out {};
+    std::string baseline {};
+    double threshold {0.1};
+};
+
+struct Result {
+    std::string scene {};
+    Size size {};
+    unsigned int threads {};
+    double wall_seconds {};
+    double rays_per_second {};
+    long peak_rss_kib {};
+
+    std::string name() const {
+        return (boost::format("%s/%dx%d/threads:%d") % scene % size.width % size.height % threads).str();
+    }
+};
+
+std::vector<std::string> split(std::string const & s, char sep) {
+    std::vector<std::string> parts;
+    std::istringstream in {s};
+    for (std::string part; std::getline(in, part, sep);) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+std::optional<Options> parse_options(int argc, char * argv[]) {
+    Options options {};
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg {argv[i]};
+        auto const eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            return std::nullopt;
+        }
+        auto const key = arg.substr(2, eq - 2);
+        auto const value = arg.substr(eq + 1);
+        try {
+            if (key == "scenes") {
+                options.scenes = value;
+            } else if (key == "sizes") {
+                options.sizes.clear();
+                for (auto const & size: split(value, ',')) {
+                    auto const x = size.find('x');
+                    if (x == std::string::npos) {
+                        return std::nullopt;
+                    }
+                    options.sizes.push_back({static_cast<unsigned int>(std::stoul(size.substr(0, x))),
+                                             static_cast<unsigned int>(std::stoul(size.substr(x + 1)))});
+                }
+            } else if (key == "threads") {
+                options.threads.clear();
+                for (auto const & threads: split(value, ',')) {
+                    options.threads.push_back(static_cast<unsigned int>(std::stoul(threads)));
+                }
+            } else if (key == "repetitions") {
+                options.repetitions = std::max(1U, static_cast<unsigned int>(std::stoul(value)));
+            } else if (key == "out") {
+                options.out = value;
+            } else if (key == "baseline") {
+                options.baseline = value;
+            } else if (key == "threshold") {
+                options.threshold = std::stod(value);
+            } else {
+                return std::nullopt;
+            }
+        } catch (std::exception const &) {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+struct Timing {
+    double seconds {-1.0};      // fastest render
+    double rays {};             // rays cast by one render
+};
+
+// Fastest of `repetitions` renders
+Timing time_render(Scene const & scene, unsigned int threads, unsigned int repetitions) {
+    auto best = std::chrono::steady_clock::duration::max();
+    RenderStats stats {};
+    for (auto i = 0U; i < repetitions; ++i) {
+        auto image {canvas(scene.camera.hsize(), scene.camera.vsize())};
+        auto const start = std::chrono::steady_clock::now();
+        stats = render(scene.camera, scene.world, image, RenderOptions {.threads = threads}).value();
+        best = std::min(best, std::chrono::steady_clock::now() - start);
+    }
+    auto const rays = STATS_ENABLED ? static_cast<double>(stats.primary_rays + stats.shadow_rays)
+                                    : static_cast<double>(scene.camera.hsize()) * scene.camera.vsize();
+    return {std::chrono::duration<double>(best).count(), rays};
+}
+
+// Run one case in a child process, which reports its time through a pipe; the
+// parent collects the child's peak RSS with wait4()
+std::optional<Result> run_case(std::string const & scene_name, Size size, unsigned int threads,
+                               unsigned int repetitions) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return std::nullopt;
+    }
+
+    auto const pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return std::nullopt;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        auto const scene = make_scene(scene_name, size.width, size.height);
+        auto const timing = scene ? time_render(*scene, threads, repetitions) : Timing {};
+        auto const written = write(fds[1], &timing, sizeof(timing));
+        _exit(written == sizeof(timing) && timing.seconds >= 0.0 ? 0 : 1);
+    }
+
+    close(fds[1]);
+    Timing timing {};
+    auto const got = read(fds[0], &timing, sizeof(timing));
+    close(fds[0]);
+
+    int status {};
+    rusage usage {};
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+        got != sizeof(timing)) {
+        return std::nullopt;
+    }
+
+    return Result {scene_name, size, threads, timing.seconds, timing.rays / timing.seconds, usage.ru_maxrss};
+}
+
+void write_json(std::ostream & os, std::vector<Result> const & results) {
+    os << std::setprecision(9) << "{\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        auto const & r = results[i];
+        os << (i ? ",\n" : "\n")
+           << "    {\"name\": \"" << r.name() << "\", \"scene\": \"" << r.scene << "\""
+           << ", \"width\": " << r.size.width << ", \"height\": " << r.size.height
+           << ", \"threads\": " << r.threads
+           << ", \"wall_seconds\": " << r.wall_seconds
+           << ", \"rays_per_second\": " << r.rays_per_second
+           << ", \"peak_rss_kib\": " << r.peak_rss_kib << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+// Wall time of each case in a saved result file, by name
+std::optional<std::map<std::string, double>> read_baseline(std::string const & path) {
+    std::map<std::string, double> baseline;
+    try {
+        boost::property_tree::ptree tree;
+        boost::property_tree::read_json(path, tree);
+        for (auto const & [_, result]: tree.get_child("results")) {
+            baseline[result.get<std::string>("name")] = result.get<double>("wall_seconds");
+        }
+    } catch (boost::property_tree::ptree_error const & e) {
+        std::cerr << "Cannot read baseline " << path << ": " << e.what() << "\n";
+        return std::nullopt;
+    }
+    return baseline;
+}
+
+// Print each case's change from the baseline; returns the number of regressions
+int compare(std::vector<Result> const & results, std::map<std::string, double> const & baseline,
+            double threshold) {
+    int regressions {0};
+    std::cout << "\nComparison with baseline (threshold " << threshold * 100.0 << "%):\n";
+    for (auto const & r: results) {
+        auto const it = baseline.find(r.name());
+        if (it == baseline.end()) {
+            std::cout << boost::format("  %-50s  not in baseline\n") % r.name();
+            continue;
+        }
+        auto const change = r.wall_seconds / it->second - 1.0;
+        auto const regressed = change > threshold;
+        regressions += regressed ? 1 : 0;
+        std::cout << boost::format("  %-50s  %+7.1f%%%s\n") % r.name() % (change * 100.0)
+                     % (regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    auto const options = parse_options(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--scenes=<regex>] [--sizes=WxH,...] [--threads=N,...]"
+                  << " [--repetitions=N] [--out=<file>] [--baseline=<file>] [--threshold=<fraction>]\n";
+        return 2;
+    }
+
+    std::optional<std::map<std::string, double>> baseline;
+    if (!options->baseline.empty()) {
+        baseline = read_baseline(options->baseline);
+        if (!baseline) {
+            return 2;
+        }
+    }
+
+    std::regex const filter {options->scenes};
+    std::vector<Result> results;
+
+    std::cout << boost::format("%-50s %10s %12s %10s\n") % "Case" % "Wall (s)" % "Rays/s" % "RSS (KiB)";
+    for (auto const & scene: named_scenes()) {
+        if (!std::regex_search(scene.name.begin(), scene.name.end(), filter)) {
+            continue;
+        }
+        for (auto const size: options->sizes) {
+            for (auto threads: options->threads) {
+                if (threads == 0) {
+                    threads = std::max(1U, std::thread::hardware_concurrency());
+                }
+                auto const result = run_case(std::string {scene.name}, size, threads, options->repetitions);
+                if (!result) {
+                    std::cerr << "Failed to run " << scene.name << "\n";
+                    return 2;
+                }
+                std::cout << boost::format("%-50s %10.4f %12.4g %10d\n") % result->name()
+                             % result->wall_seconds % result->rays_per_second % result->peak_rss_kib;
+                results.push_back(*result);
+            }
+        }
+    }
+
+    if (!options->out.empty()) {
+        std::ofstream out {options->out};
+        write_json(out, results);
+        if (!out) {
+            std::cerr << "Cannot write " << options->out << "\n";
+            return 2;
+        }
+    }
+
+    if (baseline && compare(results, *baseline, options->threshold) > 0) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef BENCH_SUPPORT_PERF_COUNTERS_H
+#define BENCH_SUPPORT_PERF_COUNTERS_H
+
+#include <benchmark/benchmark.h>
+
+#include <optional>
+
+#include <ray_tracer_challenge/perf_counters.h>
+
+// Counts hardware events from its construction, just before a benchmark's
+// loop, to its destruction, and reports them per iteration as the
+// benchmark's "cycles", "instructions", "IPC", "cache_misses" and
+// "branch_misses" counters.  Counters the system does not provide are left
+// out (see perf_counters.h).
+class BenchmarkPerfCounters {
+public:
+    explicit BenchmarkPerfCounters(benchmark::State & state) : state_{state} {
+        counters_.start();
+    }
+
+    ~BenchmarkPerfCounters() {
+        auto const counts = counters_.stop();
+        add_("cycles", counts.cycles);
+        add_("instructions", counts.instructions);
+        add_("cache_misses", counts.cache_misses);
+        add_("branch_misses", counts.branch_misses);
+        if (auto const ipc = counts.ipc()) {
+            state_.counters["IPC"] = *ipc;
+        }
+    }
+
+    BenchmarkPerfCounters(BenchmarkPerfCounters const &) = delete;
+    BenchmarkPerfCounters & operator=(BenchmarkPerfCounters const &) = delete;
+
+private:
+    void add_(char const * name, std::optional<std::uint64_t> count) {
+        if (count) {
+            state_.counters[name] = benchmark::Counter(static_cast<double>(*count), benchmark::Counter::kAvgIterations);
+        }
+    }
+
+    benchmark::State & state_;
+    rtc::PerfCounters counters_ {};
+};
+
+#endif // BENCH_SUPPORT_PERF_COUNTERS_H
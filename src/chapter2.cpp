@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/ppm.h>
 #include <ray_tracer_challenge/tuples.h>
 
 using namespace rtc;
@@ -47,8 +48,7 @@ int main(int argc, char * argv[]) {
         projectile = tick(environment, projectile);
     }
 
-    auto ppm = ppm_from_canvas(c);
-    std::cout << ppm;
+    write_ppm(std::cout, c);
 
     return 0;
 }
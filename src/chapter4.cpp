@@ -3,6 +3,7 @@
 #include <ray_tracer_challenge/matrices.h>
 #include <ray_tracer_challenge/tuples.h>
 #include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/ppm.h>
 #include <ray_tracer_challenge/transformations.h>
 
 using namespace rtc;
@@ -35,8 +36,7 @@ int main(int argc, char * argv[]) {
         p = p2;
     }
 
-    auto ppm = ppm_from_canvas(c);
-    std::cout << ppm;
+    write_ppm(std::cout, c);
 
     return 0;
 }
@@ -4,6 +4,7 @@
 #include <ray_tracer_challenge/matrices.h>
 #include <ray_tracer_challenge/tuples.h>
 #include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/ppm.h>
 #include <ray_tracer_challenge/transformations.h>
 #include <ray_tracer_challenge/rays.h>
 #include <ray_tracer_challenge/spheres.h>
@@ -100,8 +101,7 @@ int main(int argc, char * argv[]) {
         }
     }
 
-    auto ppm = ppm_from_canvas(c);
-    std::cout << ppm;
+    write_ppm(std::cout, c);
 
     return 0;
 }
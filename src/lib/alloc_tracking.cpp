@@ -0,0 +1,133 @@
+#include "ray_tracer_challenge/alloc_tracking.h"
+
+#ifdef RTC_ENABLE_ALLOC_TRACKING
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace rtc {
+
+#ifdef RTC_ENABLE_ALLOC_TRACKING
+
+namespace {
+
+std::atomic<std::uint64_t> total_allocations {0};
+std::atomic<std::uint64_t> total_deallocations {0};
+std::atomic<std::uint64_t> total_bytes {0};
+
+thread_local AllocationCounts thread_counts {};
+
+void count_allocation(std::size_t size) {
+    total_allocations.fetch_add(1, std::memory_order_relaxed);
+    total_bytes.fetch_add(size, std::memory_order_relaxed);
+    ++thread_counts.allocations;
+    thread_counts.bytes += size;
+}
+
+void count_deallocation() {
+    total_deallocations.fetch_add(1, std::memory_order_relaxed);
+    ++thread_counts.deallocations;
+}
+
+void * allocate(std::size_t size, std::size_t alignment) {
+    size = size == 0 ? 1 : size;
+    while (true) {
+        void * p {};
+        if (alignment <= alignof(std::max_align_t)) {
+            p = std::malloc(size);
+        } else {
+            // aligned_alloc wants a whole number of alignments
+            p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+        if (p) {
+            count_allocation(size);
+            return p;
+        }
+        auto const handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc {};
+        }
+        handler();
+    }
+}
+
+void * allocate_nothrow(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return allocate(size, alignment);
+    } catch (std::bad_alloc const &) {
+        return nullptr;
+    }
+}
+
+void deallocate(void * p) noexcept {
+    if (p) {
+        count_deallocation();
+        std::free(p);
+    }
+}
+
+} // namespace
+
+AllocationCounts allocation_counts() {
+    return AllocationCounts {total_allocations.load(std::memory_order_relaxed),
+                             total_deallocations.load(std::memory_order_relaxed),
+                             total_bytes.load(std::memory_order_relaxed)};
+}
+
+AllocationCounts thread_allocation_counts() {
+    return thread_counts;
+}
+
+#else
+
+AllocationCounts allocation_counts() {
+    return {};
+}
+
+AllocationCounts thread_allocation_counts() {
+    return {};
+}
+
+#endif
+
+} // namespace rtc
+
+#ifdef RTC_ENABLE_ALLOC_TRACKING
+
+// Replacements for the standard library's global operators.  Sizes are only
+// known when allocating, so freeing is only counted.
+using rtc::allocate;
+using rtc::allocate_nothrow;
+using rtc::deallocate;
+
+constexpr auto DEFAULT_ALIGNMENT = alignof(std::max_align_t);
+
+void * operator new(std::size_t size) { return allocate(size, DEFAULT_ALIGNMENT); }
+void * operator new[](std::size_t size) { return allocate(size, DEFAULT_ALIGNMENT); }
+void * operator new(std::size_t size, std::nothrow_t const &) noexcept { return allocate_nothrow(size, DEFAULT_ALIGNMENT); }
+void * operator new[](std::size_t size, std::nothrow_t const &) noexcept { return allocate_nothrow(size, DEFAULT_ALIGNMENT); }
+void * operator new(std::size_t size, std::align_val_t a) { return allocate(size, static_cast<std::size_t>(a)); }
+void * operator new[](std::size_t size, std::align_val_t a) { return allocate(size, static_cast<std::size_t>(a)); }
+void * operator new(std::size_t size, std::align_val_t a, std::nothrow_t const &) noexcept {
+    return allocate_nothrow(size, static_cast<std::size_t>(a));
+}
+void * operator new[](std::size_t size, std::align_val_t a, std::nothrow_t const &) noexcept {
+    return allocate_nothrow(size, static_cast<std::size_t>(a));
+}
+
+void operator delete(void * p) noexcept { deallocate(p); }
+void operator delete[](void * p) noexcept { deallocate(p); }
+void operator delete(void * p, std::size_t) noexcept { deallocate(p); }
+void operator delete[](void * p, std::size_t) noexcept { deallocate(p); }
+void operator delete(void * p, std::nothrow_t const &) noexcept { deallocate(p); }
+void operator delete[](void * p, std::nothrow_t const &) noexcept { deallocate(p); }
+void operator delete(void * p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void * p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete(void * p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void * p, std::size_t, std::align_val_t) noexcept { deallocate(p); }
+void operator delete(void * p, std::align_val_t, std::nothrow_t const &) noexcept { deallocate(p); }
+void operator delete[](void * p, std::align_val_t, std::nothrow_t const &) noexcept { deallocate(p); }
+
+#endif
@@ -0,0 +1,264 @@
+#include "ray_tracer_challenge/checkpoint.h"
+
+#include <bit>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <typeinfo>
+
+namespace rtc {
+
+namespace {
+
+constexpr char const * MANIFEST_MAGIC {"rtc-checkpoint"};
+constexpr int MANIFEST_VERSION {1};
+
+// 64-bit FNV-1a
+class Hasher {
+public:
+    void add(std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash_ = (hash_ ^ ((value >> (8 * i)) & 0xff)) * 0x100000001b3ULL;
+        }
+    }
+
+    void add(double value) { add(std::bit_cast<std::uint64_t>(value)); }
+
+    void add(std::string const & s) {
+        for (auto const c : s) {
+            hash_ = (hash_ ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+        }
+        add(static_cast<std::uint64_t>(s.size()));
+    }
+
+    void add(Matrix<4> const & m) {
+        for (auto r = 0U; r < 4; ++r) {
+            for (auto c = 0U; c < 4; ++c) {
+                add(m(r, c));
+            }
+        }
+    }
+
+    void add(Tuple const & t) {
+        add(t.x());
+        add(t.y());
+        add(t.z());
+        add(t.w());
+    }
+
+    std::uint64_t value() const { return hash_; }
+
+private:
+    std::uint64_t hash_ {0xcbf29ce484222325ULL};
+};
+
+void add_pattern(Hasher & h, Pattern const & pattern) {
+    h.add(std::string {typeid(pattern).name()});
+    h.add(pattern.transform());
+    for (auto const & p : {point(0.0, 0.0, 0.0), point(0.25, 0.5, 0.75), point(-1.5, 2.25, 0.1),
+                         point(3.3, -0.7, 1.9), point(10.5, 4.25, -6.125)}) {
+        h.add(pattern.pattern_at(p));
+    }
+}
+
+std::string manifest_path(Checkpoint const & checkpoint) { return checkpoint.path + ".manifest"; }
+std::string pixels_path(Checkpoint const & checkpoint) { return checkpoint.path + ".pfm"; }
+
+// Collects completed tiles from the render workers and persists them on its own thread
+class CheckpointWriter {
+public:
+    CheckpointWriter(MappedPfmStorage & storage, CheckpointManifest manifest, std::string path,
+                     std::chrono::milliseconds interval) :
+        storage_{storage}, manifest_{std::move(manifest)}, path_{std::move(path)}, interval_{interval},
+        thread_{[this] { run_(); }} {}
+
+    // Persists everything outstanding before returning
+    ~CheckpointWriter() {
+        {
+            std::lock_guard<std::mutex> lock {mutex_};
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    CheckpointWriter(CheckpointWriter const &) = delete;
+    CheckpointWriter & operator=(CheckpointWriter const &) = delete;
+
+    // Called by a worker once all of a tile's pixels are written
+    void tile_done(unsigned int index) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        completed_.push_back(index);
+    }
+
+private:
+    void run_() {
+        std::unique_lock<std::mutex> lock {mutex_};
+        while (!stopping_) {
+            cv_.wait_for(lock, interval_, [this] { return stopping_; });
+            flush_(lock);
+        }
+        flush_(lock);  // tiles completed during the last flush
+    }
+
+    void flush_(std::unique_lock<std::mutex> & lock) {
+        std::vector<unsigned int> completed;
+        completed.swap(completed_);
+        if (completed.empty()) {
+            return;
+        }
+        lock.unlock();
+        if (storage_.sync()) {
+            for (auto const index : completed) {
+                manifest_.done[index] = true;
+            }
+            write_checkpoint_manifest(path_, manifest_);
+        }
+        lock.lock();
+    }
+
+    MappedPfmStorage & storage_;
+    CheckpointManifest manifest_;
+    std::string path_;
+    std::chrono::milliseconds interval_;
+
+    std::mutex mutex_ {};
+    std::condition_variable cv_ {};
+    std::vector<unsigned int> completed_ {};
+    bool stopping_ {false};
+    std::thread thread_;   // last, so it starts once everything else is ready
+};
+
+} // namespace
+
+std::uint64_t scene_hash(World const & world) {
+    Hasher h;
+    if (world.light()) {
+        h.add(world.light()->position());
+        h.add(world.light()->intensity());
+    }
+    h.add(static_cast<std::uint64_t>(world.objects().size()));
+    for (auto const & object : world.objects()) {
+        h.add(std::string {typeid(*object).name()});
+        h.add(object->transform());
+        auto const & m = object->material();
+        h.add(m.color());
+        h.add(m.ambient());
+        h.add(m.diffuse());
+        h.add(m.specular());
+        h.add(m.shininess());
+        if (m.pattern()) {
+            add_pattern(h, *m.pattern());
+        }
+    }
+    return h.value();
+}
+
+std::uint64_t camera_hash(Camera const & camera) {
+    Hasher h;
+    h.add(static_cast<std::uint64_t>(camera.hsize()));
+    h.add(static_cast<std::uint64_t>(camera.vsize()));
+    h.add(camera.field_of_view());
+    h.add(camera.transform());
+    return h.value();
+}
+
+std::optional<CheckpointManifest> read_checkpoint_manifest(std::string const & path) {
+    std::ifstream is {path};
+    std::string magic;
+    int version {};
+    std::string key;
+    CheckpointManifest m;
+    std::size_t num_tiles {};
+    std::string done;
+    if (!(is >> magic >> version) || magic != MANIFEST_MAGIC || version != MANIFEST_VERSION
+        || !(is >> key >> std::hex >> m.scene_hash) || key != "scene"
+        || !(is >> key >> std::hex >> m.camera_hash) || key != "camera"
+        || !(is >> key >> std::dec >> m.width >> m.height) || key != "size"
+        || !(is >> key >> m.tile_size) || key != "tile_size"
+        || !(is >> key >> num_tiles >> done) || key != "tiles" || done.size() != num_tiles) {
+        return std::nullopt;
+    }
+    m.done.reserve(num_tiles);
+    for (auto const c : done) {
+        if (c != '0' && c != '1') {
+            return std::nullopt;
+        }
+        m.done.push_back(c == '1');
+    }
+    return m;
+}
+
+bool write_checkpoint_manifest(std::string const & path, CheckpointManifest const & manifest) {
+    auto const temp = path + ".tmp";
+    {
+        std::ofstream os {temp, std::ios::trunc};
+        os << MANIFEST_MAGIC << ' ' << MANIFEST_VERSION << '\n'
+           << "scene " << std::hex << manifest.scene_hash << '\n'
+           << "camera " << manifest.camera_hash << std::dec << '\n'
+           << "size " << manifest.width << ' ' << manifest.height << '\n'
+           << "tile_size " << manifest.tile_size << '\n'
+           << "tiles " << manifest.done.size() << ' ';
+        for (auto const d : manifest.done) {
+            os.put(d ? '1' : '0');
+        }
+        os << '\n';
+        if (!os.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+std::optional<MappedCanvas> render(Camera const & camera, World const & world,
+                                   RenderOptions const & options, Checkpoint const & checkpoint) {
+    detail::TileGrid const grid {camera.hsize(), camera.vsize(), options.tile_size};
+
+    CheckpointManifest expected;
+    expected.scene_hash = checkpoint.scene_hash ? *checkpoint.scene_hash : scene_hash(world);
+    expected.camera_hash = camera_hash(camera);
+    expected.width = camera.hsize();
+    expected.height = camera.vsize();
+    expected.tile_size = std::max(options.tile_size, 1U);
+    expected.done.assign(grid.size(), false);
+
+    // Resume only if everything matches; otherwise start again from scratch
+    std::optional<MappedCanvas> image;
+    auto manifest = read_checkpoint_manifest(manifest_path(checkpoint));
+    if (manifest && manifest->scene_hash == expected.scene_hash && manifest->camera_hash == expected.camera_hash
+        && manifest->width == expected.width && manifest->height == expected.height
+        && manifest->tile_size == expected.tile_size && manifest->done.size() == expected.done.size()) {
+        image = open_mapped_canvas(pixels_path(checkpoint));
+        if (image && (image->width() != expected.width || image->height() != expected.height)) {
+            image.reset();
+        }
+    }
+    if (image) {
+        expected.done = manifest->done;
+    } else {
+        image = mapped_canvas(pixels_path(checkpoint), camera.hsize(), camera.vsize());
+        if (!image || !write_checkpoint_manifest(manifest_path(checkpoint), expected)) {
+            return std::nullopt;
+        }
+    }
+
+    std::vector<unsigned int> pending;
+    for (auto i = 0U; i < grid.size(); ++i) {
+        if (!expected.done[i]) {
+            pending.push_back(i);
+        }
+    }
+
+    {
+        CheckpointWriter writer {image->storage(), expected, manifest_path(checkpoint), checkpoint.interval};
+        parallel_for(static_cast<unsigned int>(pending.size()), options.threads, [&](unsigned int i) {
+            detail::render_tile(camera, world, *image, grid[pending[i]]);
+            writer.tile_done(pending[i]);
+        }, options.pool);
+    }
+    return image;
+}
+
+} // namespace rtc
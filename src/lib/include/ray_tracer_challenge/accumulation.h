@@ -0,0 +1,260 @@
+// Progressive rendering into an accumulation buffer
+//
+// A progressive render traces many randomly placed rays through each pixel and
+// keeps, for every pixel, the number of samples and their running mean and
+// variance (Welford's algorithm), rather than a single colour.  The standard
+// error of each pixel's mean tells how far it may still be from converged.
+//
+// Rendering goes in rounds over the image's tiles.  The first gives every pixel
+// a minimum number of samples.  Each later round takes the unconverged tiles
+// with the highest error (the worst half, and at least one), and adds samples
+// to each of their pixels still above the error target, so samples go where
+// the image is noisiest and flat areas stop early.  Rendering stops when every
+// pixel has reached the error target or the per-pixel sample cap, or the
+// total sample budget is spent (checked between rounds).
+//
+// Each sample's position within its pixel comes from a hash of the seed, the
+// pixel and the sample's index, so the result does not depend on the thread
+// count or the order tiles are rendered in.
+
+#ifndef RTC_LIB_ACCUMULATION_H
+#define RTC_LIB_ACCUMULATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "camera.h"
+#include "color.h"
+#include "pixels.h"
+#include "render.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include "world.h"
+
+namespace rtc {
+
+// Running mean and variance of one pixel's samples
+class PixelAccumulator {
+public:
+    void add(Color const & sample) {
+        ++count_;
+        Color const delta = sample - mean_;
+        mean_ = mean_ + delta * (1.0 / count_);
+        m2_ = m2_ + hadamard(delta, sample - mean_);
+    }
+
+    std::uint32_t count() const { return count_; }
+    Color const & mean() const { return mean_; }
+
+    // Sample variance of each colour component; zero for fewer than two samples
+    Color variance() const {
+        return count_ > 1 ? Color {m2_ * (1.0 / (count_ - 1))} : color(0.0, 0.0, 0.0);
+    }
+
+    // Standard error of the mean in the noisiest colour component; infinite
+    // for fewer than two samples
+    double error() const {
+        if (count_ < 2) {
+            return std::numeric_limits<double>::infinity();
+        }
+        auto const v = variance();
+        return std::sqrt(std::max({v.red(), v.green(), v.blue()}) / count_);
+    }
+
+private:
+    std::uint32_t count_ {0};
+    Color mean_ {0.0, 0.0, 0.0};
+    Color m2_ {0.0, 0.0, 0.0};
+};
+
+class AccumulationBuffer {
+public:
+    AccumulationBuffer(unsigned int width, unsigned int height) :
+        width_{width}, height_{height}, pixels_(static_cast<std::size_t>(width) * height) {}
+
+    unsigned int width() const { return width_; }
+    unsigned int height() const { return height_; }
+
+    PixelAccumulator & at(unsigned int x, unsigned int y) { return pixels_[index_(x, y)]; }
+    PixelAccumulator const & at(unsigned int x, unsigned int y) const { return pixels_[index_(x, y)]; }
+
+    // Write each pixel's mean into `image`; pixels outside it are skipped
+    template <typename Canvas>
+    void resolve(Canvas & image) const {
+        using pixel_t = typename Canvas::pixel_t;
+        for (auto y = 0U; y < height_; ++y) {
+            for (auto x = 0U; x < width_; ++x) {
+                image.write_pixel(x, y, to_pixel<pixel_t>(at(x, y).mean()));
+            }
+        }
+    }
+
+    auto resolve() const {
+        auto image {canvas(width_, height_)};
+        resolve(image);
+        return image;
+    }
+
+private:
+    std::size_t index_(unsigned int x, unsigned int y) const {
+        return static_cast<std::size_t>(y) * width_ + x;
+    }
+
+    unsigned int width_;
+    unsigned int height_;
+    std::vector<PixelAccumulator> pixels_;
+};
+
+struct ProgressiveOptions {
+    double error_target {0.005};            // standard error of a pixel's mean colour component
+    unsigned int min_samples {8};           // per pixel, before its error estimate is trusted
+    unsigned int max_samples {256};         // per pixel
+    unsigned int samples_per_round {8};     // added to each unconverged pixel of a tile a round picks
+    std::uint64_t sample_budget {0};        // total samples over all rounds; 0: no limit
+    std::uint64_t seed {0};
+};
+
+struct ProgressiveStats {
+    unsigned int rounds {0};
+    std::uint64_t samples {0};
+    unsigned int tiles {0};
+    unsigned int converged_tiles {0};       // with every pixel at the error target or sample cap
+    double max_error {0.0};                 // highest pixel error left
+};
+
+namespace detail {
+
+inline std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27U)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31U);
+}
+
+// Position of sample `index` within pixel (x, y), each coordinate in [0, 1)
+inline std::pair<double, double> sample_offset(std::uint64_t seed, unsigned int x, unsigned int y,
+                                               std::uint32_t index) {
+    auto const h = splitmix64(seed ^ splitmix64((static_cast<std::uint64_t>(y) << 32U | x) ^
+                                                splitmix64(index)));
+    constexpr auto scale = 1.0 / static_cast<double>(1U << 31U);
+    return {static_cast<double>(h >> 33U) * scale, static_cast<double>(h & 0x7fffffffU) * scale};
+}
+
+inline bool converged(PixelAccumulator const & pixel, ProgressiveOptions const & options) {
+    return pixel.count() >= options.max_samples ||
+           (pixel.count() >= options.min_samples && pixel.error() <= options.error_target);
+}
+
+// Add samples to the pixels of `tile` that have not converged, bringing each
+// up to at least `target` samples.  Returns the number of samples added.
+template <typename Tile>
+std::uint64_t accumulate_tile(Camera const & camera, World const & world, AccumulationBuffer & buffer,
+                              ProgressiveOptions const & options, std::uint32_t target, Tile const & tile) {
+    std::uint64_t samples {0};
+    for (auto y = tile.y0; y < tile.y1; ++y) {
+        for (auto x = tile.x0; x < tile.x1; ++x) {
+            auto & pixel = buffer.at(x, y);
+            if (converged(pixel, options)) {
+                continue;
+            }
+            auto const end = std::min(target, options.max_samples);
+            for (auto index = pixel.count(); index < end; ++index) {
+                auto const [dx, dy] = sample_offset(options.seed, x, y, index);
+                pixel.add(color_at(world, ray_for_pixel(camera, x, y, dx, dy)));
+                ++samples;
+            }
+        }
+    }
+    return samples;
+}
+
+// Highest error of the pixels in `tile` that have not converged, if any
+template <typename Tile>
+std::optional<double> tile_error(AccumulationBuffer const & buffer, ProgressiveOptions const & options,
+                                 Tile const & tile) {
+    std::optional<double> error {};
+    for (auto y = tile.y0; y < tile.y1; ++y) {
+        for (auto x = tile.x0; x < tile.x1; ++x) {
+            auto const & pixel = buffer.at(x, y);
+            if (!converged(pixel, options)) {
+                error = std::max(error.value_or(0.0), pixel.error());
+            }
+        }
+    }
+    return error;
+}
+
+} // namespace detail
+
+// Render progressively into `buffer`, adding to any samples it already holds.
+// Tiles follow options.tile_size; progress is not reported.  Returns nothing,
+// leaving the buffer untouched, if it is smaller than hsize x vsize.
+inline std::optional<ProgressiveStats> render(Camera const & camera, World const & world, AccumulationBuffer & buffer,
+                                              ProgressiveOptions const & progressive, RenderOptions const & options) {
+    if (!detail::covers(camera, buffer)) {
+        return std::nullopt;
+    }
+    TraceSpan const span {"progressive render", "render"};
+    detail::TileGrid const grid {camera.hsize(), camera.vsize(), options.tile_size};
+    ProgressiveStats stats {};
+    stats.tiles = grid.size();
+    std::mutex stats_mutex;
+
+    struct TileState {
+        unsigned int index;
+        std::optional<double> error;    // none once converged
+        std::uint32_t target;       // samples per unconverged pixel after the tile's next round
+    };
+    std::vector<TileState> tiles(grid.size());
+    for (auto i = 0U; i < grid.size(); ++i) {
+        tiles[i] = TileState {i, std::numeric_limits<double>::infinity(),
+                              std::max(progressive.min_samples, 2U)};
+    }
+
+    auto const budget_left = [&] {
+        return progressive.sample_budget == 0 || stats.samples < progressive.sample_budget;
+    };
+
+    // Every tile takes part in the first round; later rounds take the worst
+    // half of the tiles that have not converged
+    auto selected = tiles.size();
+    while (selected > 0 && budget_left()) {
+        ++stats.rounds;
+        TraceSpan const round_span {"round", "render", stats.rounds};
+        parallel_for(static_cast<unsigned int>(selected), options.threads, [&](unsigned int i) {
+            auto & tile = tiles[i];
+            auto const samples = detail::accumulate_tile(camera, world, buffer, progressive, tile.target,
+                                                         grid[tile.index]);
+            tile.error = detail::tile_error(buffer, progressive, grid[tile.index]);
+            tile.target += std::max(progressive.samples_per_round, 1U);
+            std::lock_guard const lock {stats_mutex};
+            stats.samples += samples;
+        }, options.pool);
+
+        auto const unconverged = std::partition(tiles.begin(), tiles.end(), [](auto const & t) {
+            return t.error.has_value();
+        });
+        std::sort(tiles.begin(), unconverged, [](auto const & a, auto const & b) { return a.error > b.error; });
+        auto const remaining = static_cast<std::size_t>(unconverged - tiles.begin());
+        selected = remaining > 0 ? std::max<std::size_t>(remaining / 2, 1) : 0;
+    }
+
+    for (auto const & tile : tiles) {
+        if (tile.error) {
+            stats.max_error = std::max(stats.max_error, *tile.error);
+        } else {
+            ++stats.converged_tiles;
+        }
+    }
+    return stats;
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_ACCUMULATION_H
@@ -0,0 +1,70 @@
+// Heap allocation accounting
+//
+// With the RTC_ENABLE_ALLOC_TRACKING build option, the library replaces the
+// global operator new and delete with versions that count every allocation,
+// its size and every deallocation, both for the whole process and for each
+// thread.  AllocationScope measures a stretch of code, such as one phase of a
+// render, so tests can hold it to an allocation budget.
+//
+// Without the option nothing is replaced or counted, and every count is zero.
+
+#ifndef RTC_LIB_ALLOC_TRACKING_H
+#define RTC_LIB_ALLOC_TRACKING_H
+
+#include <cstdint>
+
+namespace rtc {
+
+#ifdef RTC_ENABLE_ALLOC_TRACKING
+constexpr bool ALLOC_TRACKING_ENABLED {true};
+#else
+constexpr bool ALLOC_TRACKING_ENABLED {false};
+#endif
+
+struct AllocationCounts {
+    std::uint64_t allocations {};
+    std::uint64_t deallocations {};
+    std::uint64_t bytes {};             // allocated, not counting what was freed
+
+    AllocationCounts & operator-=(AllocationCounts const & rhs) {
+        allocations -= rhs.allocations;
+        deallocations -= rhs.deallocations;
+        bytes -= rhs.bytes;
+        return *this;
+    }
+
+    friend bool operator==(AllocationCounts const &, AllocationCounts const &) = default;
+};
+
+inline AllocationCounts operator-(AllocationCounts lhs, AllocationCounts const & rhs) {
+    return lhs -= rhs;
+}
+
+// Everything counted so far, on all threads
+AllocationCounts allocation_counts();
+
+// Everything counted so far on this thread
+AllocationCounts thread_allocation_counts();
+
+// Counts from its construction, on all threads or only the constructing one
+class AllocationScope {
+public:
+    enum class Threads { all, this_thread };
+
+    explicit AllocationScope(Threads threads = Threads::all) :
+        threads_{threads}, start_{now_()} {}
+
+    AllocationCounts counts() const { return now_() - start_; }
+
+private:
+    AllocationCounts now_() const {
+        return threads_ == Threads::all ? allocation_counts() : thread_allocation_counts();
+    }
+
+    Threads threads_;
+    AllocationCounts start_;
+};
+
+} // namespace rtc
+
+#endif // RTC_LIB_ALLOC_TRACKING_H
@@ -0,0 +1,152 @@
+// Adaptive supersampling
+//
+// An anti-aliased render first traces one ray through the centre of every
+// pixel, as a plain render does.  Only pixels whose colour differs from one of
+// their four neighbours by more than a threshold, or which show a different
+// object from one of them, are then refined: their colour becomes the average
+// of a regular grid of subpixel samples.  Edges and shadow boundaries get the
+// extra rays and flat areas cost no more than before.
+//
+// Each tile traces the centre samples of a one pixel border around itself as
+// well, so that it can compare its edge pixels with their neighbours without
+// waiting for the tiles next to it.
+
+#ifndef RTC_LIB_ANTIALIAS_H
+#define RTC_LIB_ANTIALIAS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "camera.h"
+#include "pixels.h"
+#include "render.h"
+#include "world.h"
+
+namespace rtc {
+
+struct Antialiasing {
+    double threshold {0.1};     // largest difference in any colour component (clamped to [0, 1]) left unrefined
+    unsigned int grid {4};      // a refined pixel is the average of grid x grid samples
+};
+
+struct AntialiasStats {
+    std::uint64_t pixels {0};
+    std::uint64_t refined_pixels {0};
+    std::uint64_t samples {0};          // camera rays traced, including each tile's border
+
+    double refined_fraction() const {
+        return pixels > 0 ? static_cast<double>(refined_pixels) / static_cast<double>(pixels) : 0.0;
+    }
+
+    AntialiasStats & operator+=(AntialiasStats const & rhs) {
+        pixels += rhs.pixels;
+        refined_pixels += rhs.refined_pixels;
+        samples += rhs.samples;
+        return *this;
+    }
+};
+
+namespace detail {
+
+// Whether two centre samples are different enough for both pixels to be refined
+inline bool needs_refinement(Sample const & a, Sample const & b, double threshold) {
+    if (a.object != b.object) {
+        return true;
+    }
+    auto const difference = [](double u, double v) {
+        return std::abs(std::clamp(u, 0.0, 1.0) - std::clamp(v, 0.0, 1.0));
+    };
+    return difference(a.color.red(), b.color.red()) > threshold ||
+           difference(a.color.green(), b.color.green()) > threshold ||
+           difference(a.color.blue(), b.color.blue()) > threshold;
+}
+
+// The average of a grid x grid of samples spread evenly over pixel (px, py)
+inline Color supersample(Camera const & camera, World const & world, unsigned int px, unsigned int py,
+                         unsigned int grid) {
+    auto sum = color(0.0, 0.0, 0.0);
+    for (auto j = 0U; j < grid; ++j) {
+        for (auto i = 0U; i < grid; ++i) {
+            auto const ray {ray_for_pixel(camera, px, py, (i + 0.5) / grid, (j + 0.5) / grid)};
+            sum = sum + color_at(world, ray);
+        }
+    }
+    return sum * (1.0 / (grid * grid));
+}
+
+template <typename Canvas, typename Tile>
+AntialiasStats render_tile_antialiased(Camera const & camera, World const & world, Canvas & image,
+                                       Antialiasing const & antialiasing, Tile const & tile) {
+    using pixel_t = typename Canvas::pixel_t;
+
+    // Centre samples of the tile and its border, clipped to the image
+    auto const x0 = tile.x0 > 0 ? tile.x0 - 1 : 0U;
+    auto const y0 = tile.y0 > 0 ? tile.y0 - 1 : 0U;
+    auto const x1 = std::min(tile.x1 + 1, camera.hsize());
+    auto const y1 = std::min(tile.y1 + 1, camera.vsize());
+    auto const width = x1 - x0;
+    std::vector<Sample> samples;
+    samples.reserve(static_cast<std::size_t>(width) * (y1 - y0));
+    for (auto y = y0; y < y1; ++y) {
+        for (auto x = x0; x < x1; ++x) {
+            samples.push_back(sample_at(world, ray_for_pixel(camera, x, y)));
+        }
+    }
+    auto const at = [&](unsigned int x, unsigned int y) -> Sample const & {
+        return samples[static_cast<std::size_t>(y - y0) * width + (x - x0)];
+    };
+
+    AntialiasStats stats {};
+    stats.samples = samples.size();
+    auto const grid = std::max(antialiasing.grid, 1U);
+    auto const pixels = tile_view(image, tile);
+    for (auto y = tile.y0; y < tile.y1; ++y) {
+        auto const row = pixels.row(y - tile.y0);
+        for (auto x = tile.x0; x < tile.x1; ++x) {
+            auto const & centre = at(x, y);
+            auto const refine = (x > x0 && needs_refinement(centre, at(x - 1, y), antialiasing.threshold)) ||
+                                (x + 1 < x1 && needs_refinement(centre, at(x + 1, y), antialiasing.threshold)) ||
+                                (y > y0 && needs_refinement(centre, at(x, y - 1), antialiasing.threshold)) ||
+                                (y + 1 < y1 && needs_refinement(centre, at(x, y + 1), antialiasing.threshold));
+            if (refine) {
+                row[x - tile.x0] = to_pixel<pixel_t>(supersample(camera, world, x, y, grid));
+                ++stats.refined_pixels;
+                stats.samples += grid * grid;
+            } else {
+                row[x - tile.x0] = to_pixel<pixel_t>(centre.color);
+            }
+        }
+    }
+    stats.pixels = static_cast<std::uint64_t>(tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+    return stats;
+}
+
+} // namespace detail
+
+// Render as render(camera, world, image, options) does, with adaptive
+// supersampling, adding the number of pixels refined and rays traced to
+// `refinement`.  The result does not depend on the tile size or thread count.
+// A threshold below zero refines every pixel (uniform supersampling).  Returns
+// nothing, and renders nothing, if the canvas is smaller than hsize x vsize.
+template <typename Canvas>
+std::optional<RenderStats> render(Camera const & camera, World const & world, Canvas & image,
+                                  AntialiasStats & refinement, RenderOptions const & options,
+                                  Antialiasing const & antialiasing = {}) {
+    if (!detail::covers(camera, image)) {
+        return std::nullopt;
+    }
+    std::mutex refinement_mutex;
+    return detail::render_tiles<Canvas>(camera, options, [&](auto const & tile) {
+        auto const tile_stats = detail::render_tile_antialiased(camera, world, image, antialiasing, tile);
+        std::lock_guard const lock {refinement_mutex};
+        refinement += tile_stats;
+    });
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_ANTIALIAS_H
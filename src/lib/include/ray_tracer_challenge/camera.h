@@ -10,6 +10,7 @@
 #include "rays.h"
 #include "world.h"
 #include "canvas.h"
+#include "pixels.h"
 
 namespace rtc {
 
@@ -64,10 +65,14 @@ inline auto camera(unsigned int hsize, unsigned int vsize, fp_t field_of_view) {
     return Camera {hsize, vsize, field_of_view};
 }
 
-inline auto ray_for_pixel(Camera const & camera, unsigned int px, unsigned int py) {
-    // the offset from the edge of the canvas to the pixel's center
-    auto const xoffset = (px + 0.5) * camera.pixel_size();
-    auto const yoffset = (py + 0.5) * camera.pixel_size();
+// The ray through the point (dx, dy) of pixel (px, py), where (0, 0) is the
+// pixel's top left corner and (1, 1) its bottom right
+inline auto ray_for_pixel(Camera const & camera, unsigned int px, unsigned int py, fp_t dx, fp_t dy) {
+    count_stat<&RenderStats::primary_rays>();
+
+    // the offset from the edge of the canvas to the point in the pixel
+    auto const xoffset = (px + dx) * camera.pixel_size();
+    auto const yoffset = (py + dy) * camera.pixel_size();
 
     // the untransformed coordinates of the pixel in world space.
     // (the camera looks toward -Z, so +X is to the *left*)
@@ -85,15 +90,47 @@ inline auto ray_for_pixel(Camera const & camera, unsigned int px, unsigned int p
     return ray(origin, direction);
 }
 
-inline auto render(Camera const & camera, World const & world) {
-    auto image {canvas(camera.hsize(), camera.vsize())};
-    for (unsigned int y = 0; y < camera.vsize(); ++y) {
-        for (unsigned int x = 0; x < camera.hsize(); ++x) {
-            auto const ray {ray_for_pixel(camera, x, y)};
-            auto const color {color_at(world, ray)};
-            write_pixel(image, x, y, color);
+// The ray through the centre of pixel (px, py)
+inline auto ray_for_pixel(Camera const & camera, unsigned int px, unsigned int py) {
+    return ray_for_pixel(camera, px, py, 0.5, 0.5);
+}
+
+// Render into an existing canvas of at least hsize x vsize pixels.  The canvas
+// may use any pixel type and storage.  Returns false, leaving the canvas
+// untouched, if it is smaller.
+template <typename Canvas>
+requires requires { typename Canvas::pixel_t; }
+bool render(Camera const & camera, World const & world, Canvas & image) {
+    if (image.width() < camera.hsize() || image.height() < camera.vsize()) {
+        return false;
+    }
+    using pixel_t = typename Canvas::pixel_t;
+    auto const shade = [&](unsigned int x, unsigned int y) {
+        auto const ray {ray_for_pixel(camera, x, y)};
+        return to_pixel<pixel_t>(color_at(world, ray));
+    };
+
+    if constexpr (requires { image.view(); }) {
+        auto const pixels = image.view();
+        for (unsigned int y = 0; y < camera.vsize(); ++y) {
+            auto const row = pixels.row(y);
+            for (unsigned int x = 0; x < camera.hsize(); ++x) {
+                row[x] = shade(x, y);
+            }
+        }
+    } else {
+        for (unsigned int y = 0; y < camera.vsize(); ++y) {
+            for (unsigned int x = 0; x < camera.hsize(); ++x) {
+                image.storage().at(x, y) = shade(x, y);
+            }
         }
     }
+    return true;
+}
+
+inline auto render(Camera const & camera, World const & world) {
+    auto image {canvas(camera.hsize(), camera.vsize())};
+    render(camera, world, image);
     return image;
 }
 
@@ -1,87 +1,173 @@
 #ifndef RTC_LIB_CANVAS_H
 #define RTC_LIB_CANVAS_H
 
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 #include <optional>
+#include <utility>
 #include <string>
 #include <fstream>
 
-#include <boost/format.hpp>
-
 #include "color.h"
+#include "pixel_view.h"
+#include "pixels.h"
+#include "ppm.h"
 
 namespace rtc {
 
-namespace detail {
+// Default canvas storage: pixels held in memory row by row, starting with
+// the top left (x = 0, y = 0)
+template <typename PixelType>
+class VectorStorage {
+public:
+    using pixel_t = PixelType;
 
-template <typename T>
-inline void add_value(std::string & row, T value) {
-    const auto v = std::min(std::max(value, 0.0), 1.0);
-    const unsigned int ivalue = std::rint(v * 255);
-    if (!row.empty()) {
-        row += ' ';
+    VectorStorage() = default;
+    VectorStorage(unsigned int width, unsigned int height) :
+        width_(width), height_(height), pixels_(static_cast<std::size_t>(width) * height) {}
+
+    PixelType & at(unsigned int x, unsigned int y) {
+        return pixels_[x + static_cast<std::size_t>(y) * width_];
     }
-    row += std::to_string(ivalue);
-}
 
-inline void split_line_by(std::vector<std::string> & lines,
-                   std::string_view line, int limit) {
-    if (line.length() > 70) {
-        const auto idx = line.rfind(' ', 70 - 1);
-        lines.emplace_back(line.substr(0, idx));
-        line = line.substr(idx + 1);
-        split_line_by(lines, line, limit);
-    } else {
-        lines.emplace_back(line);
+    PixelType const & at(unsigned int x, unsigned int y) const {
+        return pixels_[x + static_cast<std::size_t>(y) * width_];
     }
-}
 
-} // namespace detail
+    PixelView<PixelType> view() {
+        return {pixels_.data(), width_, height_, width_};
+    }
 
-template <typename PixelType>
+    PixelView<PixelType const> view() const {
+        return {pixels_.data(), width_, height_, width_};
+    }
+
+private:
+    unsigned int width_ {};
+    unsigned int height_ {};
+    std::vector<PixelType> pixels_ {};
+};
+
+// Tiled canvas storage: each TileSize x TileSize tile is contiguous in memory,
+// tiles stored row by row.  A renderer working tile by tile then touches a few
+// adjacent pages rather than one cache line per row, and threads working on
+// neighbouring tiles do not share cache lines.  Width and height are padded up
+// to whole tiles.  Use linearize() to get a row-by-row canvas for output.
+template <typename PixelType, unsigned int TileSize = 32>
+class TiledStorage {
+public:
+    static_assert(TileSize > 0 && (TileSize & (TileSize - 1)) == 0, "TileSize must be a power of two");
+
+    using pixel_t = PixelType;
+    static constexpr unsigned int tile_size {TileSize};
+
+    TiledStorage() = default;
+    TiledStorage(unsigned int width, unsigned int height) :
+        tiles_x_((width + TileSize - 1) / TileSize),
+        pixels_(static_cast<std::size_t>(tiles_x_) * ((height + TileSize - 1) / TileSize) * TileSize * TileSize) {}
+
+    PixelType & at(unsigned int x, unsigned int y) {
+        return pixels_[index_(x, y)];
+    }
+
+    PixelType const & at(unsigned int x, unsigned int y) const {
+        return pixels_[index_(x, y)];
+    }
+
+    // The whole tile containing pixel (x, y), including any padding beyond the
+    // canvas edge
+    PixelView<PixelType> tile(unsigned int x, unsigned int y) {
+        return {&at(x / TileSize * TileSize, y / TileSize * TileSize), TileSize, TileSize, TileSize};
+    }
+
+    PixelView<PixelType const> tile(unsigned int x, unsigned int y) const {
+        return {&at(x / TileSize * TileSize, y / TileSize * TileSize), TileSize, TileSize, TileSize};
+    }
+
+private:
+    std::size_t index_(unsigned int x, unsigned int y) const {
+        auto const tile = static_cast<std::size_t>(y / TileSize) * tiles_x_ + x / TileSize;
+        return tile * TileSize * TileSize + (y % TileSize) * TileSize + x % TileSize;
+    }
+
+    unsigned int tiles_x_ {};
+    std::vector<PixelType> pixels_ {};
+};
+
+template <typename PixelType, typename Storage = VectorStorage<PixelType>>
 class Canvas {
 public:
     using pixel_t = PixelType;
+    using storage_t = Storage;
 
     Canvas() = default;
     Canvas(unsigned int width, unsigned int height) :
         width_(width), height_(height),
-        pixels_(width_ * height_) {}
+        storage_(width_, height_) {}
+
+    // Use storage that has already been sized for width x height pixels
+    Canvas(unsigned int width, unsigned int height, Storage storage) :
+        width_(width), height_(height),
+        storage_(std::move(storage)) {}
 
     auto width() const { return width_; }
     auto height() const { return height_; }
 
     std::optional<PixelType> pixel_at(unsigned int x, unsigned int y) const {
-        auto index = index_of_(x, y);
-        if (index) {
-            return pixels_[*index];
+        if (contains_(x, y)) {
+            return storage_.at(x, y);
         } else {
             return std::nullopt;
         }
     }
 
     void write_pixel(unsigned int x, unsigned int y, PixelType p) {
-        auto index = index_of_(x, y);
-        if (index) {
-            pixels_[*index] = p;
+        if (contains_(x, y)) {
+            storage_.at(x, y) = p;
         }
     }
 
+    // Unchecked access, for storage that keeps each row contiguous.  The caller
+    // keeps x, y and the extents inside the canvas.
+    auto view() requires requires (Storage & s) { s.view(); } {
+        return storage_.view();
+    }
+
+    auto view() const requires requires (Storage const & s) { s.view(); } {
+        return storage_.view();
+    }
+
+    auto view(unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+    requires requires (Storage & s) { s.view(); } {
+        return storage_.view().subview(x, y, width, height);
+    }
+
+    auto view(unsigned int x, unsigned int y, unsigned int width, unsigned int height) const
+    requires requires (Storage const & s) { s.view(); } {
+        return storage_.view().subview(x, y, width, height);
+    }
+
+    auto row(unsigned int y) requires requires (Storage & s) { s.view(); } {
+        return storage_.view().row(y);
+    }
+
+    auto row(unsigned int y) const requires requires (Storage const & s) { s.view(); } {
+        return storage_.view().row(y);
+    }
+
+    Storage & storage() { return storage_; }
+    Storage const & storage() const { return storage_; }
+
 private:
-    std::optional<unsigned int> index_of_(unsigned int x, unsigned int y) const {
-        if (x < width_ && y < height_) {
-            return x + y * width_;
-        }
-        return std::nullopt;
+    bool contains_(unsigned int x, unsigned int y) const {
+        return x < width_ && y < height_;
     }
 
 private:
     unsigned int width_ {};
     unsigned int height_ {};
-
-    // Store pixels row by row, starting with
-    // the top left (x = 0, y = 0)
-    std::vector<PixelType> pixels_ {};
+    Storage storage_ {};
 };
 
 template <typename PixelType=Color>
@@ -89,6 +175,36 @@ auto canvas(unsigned int width, unsigned int height) {
     return Canvas<PixelType> {width, height};
 }
 
+// Copy a canvas, converting every pixel to PixelType
+template <typename PixelType, typename Canvas>
+auto convert_canvas(Canvas const & src) {
+    ::rtc::Canvas<PixelType> dst {src.width(), src.height()};
+    detail::RowReader rows {src};
+    for (auto y = 0U; y < src.height(); ++y) {
+        convert_pixels<PixelType>(rows(y), dst.row(y));
+    }
+    return dst;
+}
+
+template <typename PixelType, unsigned int TileSize = 32>
+auto tiled_canvas(unsigned int width, unsigned int height) {
+    return Canvas<PixelType, TiledStorage<PixelType, TileSize>> {width, height};
+}
+
+// Copy a tiled canvas into row-by-row order, one tile row segment at a time
+template <typename PixelType, unsigned int TileSize>
+auto linearize(Canvas<PixelType, TiledStorage<PixelType, TileSize>> const & src) {
+    Canvas<PixelType> dst {src.width(), src.height()};
+    for (auto y = 0U; y < src.height(); ++y) {
+        auto const row = dst.row(y);
+        for (auto x = 0U; x < src.width(); x += TileSize) {
+            auto const n = std::min(TileSize, src.width() - x);
+            std::copy_n(&src.storage().at(x, y), n, row.begin() + x);
+        }
+    }
+    return dst;
+}
+
 template <typename Canvas>
 auto pixel_at(Canvas const & canvas, unsigned int x, unsigned int y) {
     return canvas.pixel_at(x, y);
@@ -99,33 +215,6 @@ auto write_pixel(Canvas & canvas, unsigned int x, unsigned int y, typename Canva
     canvas.write_pixel(x, y, color);
 }
 
-template <typename Canvas>
-auto ppm_from_canvas(Canvas const & canvas) {
-    const auto header = (boost::format("P3\n%1% %2%\n255\n") % canvas.width() % canvas.height()).str();
-
-    std::string data;
-
-    for (auto y = 0U; y < canvas.height(); ++y) {
-        std::string row;
-        for (auto x = 0U; x < canvas.width(); ++x) {
-            const auto p = canvas.pixel_at(x, y);
-
-            detail::add_value(row, p->red());
-            detail::add_value(row, p->green());
-            detail::add_value(row, p->blue());
-        }
-
-        std::vector<std::string> lines;
-        detail::split_line_by(lines, row, 70);
-
-        for (auto & i : lines) {
-            data += i + '\n';
-        }
-    }
-
-    return header + data;
-}
-
 template <typename T>
 auto write_to_file(std::string const & filename, T const & obj) {
     std::ofstream out(filename);
@@ -0,0 +1,71 @@
+// Checkpoint and resume for long renders
+//
+// A checkpointed render writes its pixels straight into a memory-mapped PFM
+// file (see mapped_canvas.h) and keeps a small text manifest alongside it,
+// recording which scene and camera are being rendered and which tiles are
+// complete.  A background thread periodically syncs the pixel file and then
+// rewrites the manifest, so workers never wait on disk.  Because the pixels
+// are synced before the manifest names their tiles, the manifest never claims
+// a tile whose pixels have not been written.
+//
+// Re-running the same render with the same checkpoint path resumes: tiles the
+// manifest marks complete are skipped.
+
+#ifndef RTC_LIB_CHECKPOINT_H
+#define RTC_LIB_CHECKPOINT_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "camera.h"
+#include "mapped_canvas.h"
+#include "render.h"
+#include "world.h"
+
+namespace rtc {
+
+struct Checkpoint {
+    // Pixels go to path + ".pfm", the manifest to path + ".manifest"
+    std::string path {};
+    // How often completed tiles are persisted
+    std::chrono::milliseconds interval {std::chrono::seconds {10}};
+    // Identifies the scene; defaults to scene_hash(world).  Set it explicitly if
+    // scenes might differ in ways scene_hash() does not capture.
+    std::optional<std::uint64_t> scene_hash {};
+};
+
+struct CheckpointManifest {
+    std::uint64_t scene_hash {};
+    std::uint64_t camera_hash {};
+    unsigned int width {};
+    unsigned int height {};
+    unsigned int tile_size {};
+    std::vector<bool> done {};      // one entry per tile, in TileGrid order
+};
+
+// Hash of the objects, materials and light in a world.  Patterns are hashed by
+// type, transform and their colour at a few fixed points.
+std::uint64_t scene_hash(World const & world);
+
+// Hash of the camera's resolution, field of view and transform
+std::uint64_t camera_hash(Camera const & camera);
+
+std::optional<CheckpointManifest> read_checkpoint_manifest(std::string const & path);
+
+// Written to a temporary file, then renamed over `path`, so the manifest is
+// always either the old or the new version
+bool write_checkpoint_manifest(std::string const & path, CheckpointManifest const & manifest);
+
+// Render with periodic checkpoints, resuming from an earlier checkpoint of the
+// same scene, camera and tile size if there is one.  Returns the finished image,
+// mapped from checkpoint.path + ".pfm", or std::nullopt if the checkpoint files
+// could not be created.
+std::optional<MappedCanvas> render(Camera const & camera, World const & world,
+                                   RenderOptions const & options, Checkpoint const & checkpoint);
+
+} // namespace rtc
+
+#endif // RTC_LIB_CHECKPOINT_H
@@ -1,6 +1,10 @@
 #ifndef RTC_LIB_COLOR_H
 #define RTC_LIB_COLOR_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
 #include "tuples.h"
 
 namespace rtc {
@@ -74,6 +78,16 @@ inline auto color(fp_t t, Color const & a, Color const & b) {
     return a + distance * fraction;
 }
 
+namespace detail {
+
+// Clamp a channel value to [0, 1] and scale to an 8-bit value
+inline std::uint8_t quantize_channel(fp_t value) {
+    auto const v = std::min(std::max(value, 0.0), 1.0);
+    return static_cast<std::uint8_t>(std::rint(v * 255));
+}
+
+} // namespace detail
+
 const auto black {color(0.0, 0.0, 0.0)};
 const auto red {color(1.0, 0.0, 0.0)};
 const auto green {color(0.0, 1.0, 0.0)};
@@ -0,0 +1,192 @@
+// Per-pixel render cost
+//
+// A cost render records how much work each pixel took into a CostMap beside
+// the canvas: either elapsed time stamp counter cycles, or the number of
+// ray-shape intersection tests (which needs RTC_ENABLE_STATS, and is exactly
+// repeatable).  The map can be written out as raw data (a greyscale PFM) or
+// as a false-colour heatmap, to see which parts of a scene are expensive.
+
+#ifndef RTC_LIB_COST_MAP_H
+#define RTC_LIB_COST_MAP_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "canvas.h"
+#include "pfm.h"
+#include "pixels.h"
+#include "render.h"
+#include "stats.h"
+
+namespace rtc {
+
+enum class CostMetric {
+    cycles,                 // time stamp counter cycles; steady_clock nanoseconds where there is no TSC
+    intersection_tests,     // sphere and plane tests; always zero without RTC_ENABLE_STATS
+};
+
+class CostMap {
+public:
+    CostMap(unsigned int width, unsigned int height) :
+        width_{width}, height_{height}, costs_(static_cast<std::size_t>(width) * height) {}
+
+    unsigned int width() const { return width_; }
+    unsigned int height() const { return height_; }
+
+    std::uint64_t & at(unsigned int x, unsigned int y) { return costs_[index_(x, y)]; }
+    std::uint64_t at(unsigned int x, unsigned int y) const { return costs_[index_(x, y)]; }
+
+    // All costs, row by row
+    std::span<std::uint64_t const> costs() const { return costs_; }
+
+    // Total cost of the pixels in [x0, x1) x [y0, y1), e.g. to weigh tiles
+    std::uint64_t sum(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) const {
+        std::uint64_t total {0};
+        for (auto y = y0; y < y1; ++y) {
+            for (auto x = x0; x < x1; ++x) {
+                total += at(x, y);
+            }
+        }
+        return total;
+    }
+
+private:
+    std::size_t index_(unsigned int x, unsigned int y) const {
+        return static_cast<std::size_t>(y) * width_ + x;
+    }
+
+    unsigned int width_;
+    unsigned int height_;
+    std::vector<std::uint64_t> costs_;
+};
+
+namespace detail {
+
+inline std::uint64_t cycle_count() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline std::uint64_t cost_counter(CostMetric metric) {
+    if (metric == CostMetric::cycles) {
+        return cycle_count();
+    }
+    auto const stats = thread_render_stats();
+    return stats.sphere_tests + stats.plane_tests;
+}
+
+template <typename Canvas, typename Tile>
+void render_tile_costs(Camera const & camera, World const & world, Canvas & image, CostMap & costs,
+                       CostMetric metric, Tile const & tile) {
+    using pixel_t = typename Canvas::pixel_t;
+    auto const pixels = tile_view(image, tile);
+    for (auto y = 0U; y < pixels.height(); ++y) {
+        auto const row = pixels.row(y);
+        for (auto x = 0U; x < pixels.width(); ++x) {
+            auto const start = cost_counter(metric);
+            auto const ray {ray_for_pixel(camera, tile.x0 + x, tile.y0 + y)};
+            row[x] = to_pixel<pixel_t>(color_at(world, ray));
+            costs.at(tile.x0 + x, tile.y0 + y) = cost_counter(metric) - start;
+        }
+    }
+}
+
+// Colour map stops: matplotlib's "inferno", sampled at 0, 1/4, 1/2, 3/4 and 1
+inline constexpr std::array<std::array<float, 3>, 5> HEATMAP_STOPS {{
+    {0.0f, 0.0f, 4.0f},
+    {87.0f, 16.0f, 110.0f},
+    {188.0f, 55.0f, 84.0f},
+    {249.0f, 142.0f, 9.0f},
+    {252.0f, 255.0f, 164.0f},
+}};
+
+inline Rgb8 heatmap_color(float t) {
+    t = std::clamp(t, 0.0f, 1.0f) * (HEATMAP_STOPS.size() - 1);
+    auto const i = std::min(static_cast<std::size_t>(t), HEATMAP_STOPS.size() - 2);
+    auto const f = t - static_cast<float>(i);
+    auto channel = [&](std::size_t c) {
+        auto const v = HEATMAP_STOPS[i][c] + f * (HEATMAP_STOPS[i + 1][c] - HEATMAP_STOPS[i][c]);
+        return static_cast<std::uint8_t>(std::lround(v));
+    };
+    return Rgb8 {channel(0), channel(1), channel(2)};
+}
+
+} // namespace detail
+
+// Render as render(camera, world, image, options) does, also recording each
+// pixel's cost into `costs`.  Returns nothing, and renders nothing, if either
+// the canvas or `costs` is smaller than hsize x vsize.  Measuring adds a
+// little work per pixel, so the render is slightly slower.
+template <typename Canvas>
+std::optional<RenderStats> render(Camera const & camera, World const & world, Canvas & image, CostMap & costs,
+                                  RenderOptions const & options, CostMetric metric = CostMetric::cycles) {
+    if (!detail::covers(camera, image) || !detail::covers(camera, costs)) {
+        return std::nullopt;
+    }
+    return detail::render_tiles<Canvas>(camera, options, [&](auto const & tile) {
+        detail::render_tile_costs(camera, world, image, costs, metric, tile);
+    });
+}
+
+struct HeatmapOptions {
+    // Costs at or above this fraction of pixels are shown at full scale, so a
+    // few outliers (e.g. pixels interrupted by the OS) do not wash out the rest
+    double clip_percentile {0.99};
+    // Scale by log(1 + cost), to show detail among the cheaper pixels
+    bool log_scale {false};
+};
+
+// False-colour image of a cost map, scaled from the cheapest pixel (black) up
+// through purple, red and orange to the clip percentile (pale yellow)
+inline Canvas<Rgb8> cost_heatmap(CostMap const & costs, HeatmapOptions const & options = {}) {
+    auto scale = [&](std::uint64_t c) {
+        return options.log_scale ? std::log1p(static_cast<double>(c)) : static_cast<double>(c);
+    };
+
+    std::vector<std::uint64_t> sorted(costs.costs().begin(), costs.costs().end());
+    double low {0.0};
+    double range {0.0};
+    if (!sorted.empty()) {
+        auto const rank = static_cast<std::size_t>(std::clamp(options.clip_percentile, 0.0, 1.0) * (sorted.size() - 1));
+        std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(rank), sorted.end());
+        low = scale(*std::min_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(rank) + 1));
+        range = scale(sorted[rank]) - low;
+    }
+
+    Canvas<Rgb8> image {costs.width(), costs.height()};
+    auto pixels = image.view();
+    for (auto y = 0U; y < costs.height(); ++y) {
+        auto const row = pixels.row(y);
+        for (auto x = 0U; x < costs.width(); ++x) {
+            auto const t = range > 0.0 ? (scale(costs.at(x, y)) - low) / range : 0.0;
+            row[x] = detail::heatmap_color(static_cast<float>(t));
+        }
+    }
+    return image;
+}
+
+// Write the raw costs as a greyscale PFM (as 32-bit floats, exact up to 2^24)
+inline std::ostream & write_cost_pfm(std::ostream & os, CostMap const & costs) {
+    std::vector<float> values(costs.costs().size());
+    std::transform(costs.costs().begin(), costs.costs().end(), values.begin(),
+                   [](std::uint64_t c) { return static_cast<float>(c); });
+    return write_pfm(os, costs.width(), costs.height(), values);
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_COST_MAP_H
@@ -0,0 +1,315 @@
+// OpenEXR image input and output
+//
+// A minimal writer and reader for single-part, uncompressed, scanline OpenEXR
+// files with 32-bit float R, G and B channels.  Like PFM, this keeps the raw
+// canvas values for later post-processing, in a format most HDR tools accept.
+//
+// File layout: https://openexr.com/en/latest/OpenEXRFileLayout.html
+
+#ifndef RTC_LIB_EXR_H
+#define RTC_LIB_EXR_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "canvas.h"
+#include "color.h"
+#include "pfm.h"
+#include "pixel_view.h"
+#include "ppm.h"
+
+namespace rtc {
+
+namespace detail {
+
+constexpr std::uint32_t EXR_MAGIC {20000630};
+constexpr std::int32_t EXR_PIXEL_TYPE_FLOAT {2};
+constexpr std::uint8_t EXR_NO_COMPRESSION {0};
+
+// Little-endian encoding helpers
+class ExrBuffer {
+public:
+    void u8(std::uint8_t v) { data.push_back(static_cast<char>(v)); }
+
+    void u32(std::uint32_t v) {
+        data.resize(data.size() + sizeof(v));
+        store_u32_le(data.data() + data.size() - sizeof(v), v);
+    }
+
+    void i32(std::int32_t v) { u32(static_cast<std::uint32_t>(v)); }
+
+    void u64(std::uint64_t v) {
+        for (int i = 0; i < 8; ++i) {
+            u8(static_cast<std::uint8_t>(v >> (8 * i)));
+        }
+    }
+
+    void f32(float v) { u32(std::bit_cast<std::uint32_t>(v)); }
+
+    void str(std::string const & s) {
+        data.insert(data.end(), s.begin(), s.end());
+        u8(0);
+    }
+
+    void attribute(std::string const & name, std::string const & type, std::uint32_t size) {
+        str(name);
+        str(type);
+        u32(size);
+    }
+
+    std::vector<char> data {};
+};
+
+// Channels must be stored in alphabetical order
+constexpr std::array<char const *, 3> EXR_CHANNELS {"B", "G", "R"};
+
+// The complete EXR file, ready for a single write
+template <typename Canvas>
+std::vector<char> exr_from_canvas(Canvas const & canvas) {
+    auto const width = static_cast<std::int32_t>(canvas.width());
+    auto const height = static_cast<std::int32_t>(canvas.height());
+
+    ExrBuffer out;
+    out.u32(EXR_MAGIC);
+    out.u32(2);  // version 2, single-part scanline file
+
+    out.attribute("channels", "chlist", EXR_CHANNELS.size() * 18 + 1);
+    for (auto const * name : EXR_CHANNELS) {
+        out.str(name);
+        out.i32(EXR_PIXEL_TYPE_FLOAT);
+        out.u8(0);  // pLinear
+        out.u8(0);  // reserved
+        out.u8(0);
+        out.u8(0);
+        out.i32(1);  // xSampling
+        out.i32(1);  // ySampling
+    }
+    out.u8(0);
+
+    out.attribute("compression", "compression", 1);
+    out.u8(EXR_NO_COMPRESSION);
+
+    for (auto const * window : {"dataWindow", "displayWindow"}) {
+        out.attribute(window, "box2i", 16);
+        out.i32(0);
+        out.i32(0);
+        out.i32(width - 1);
+        out.i32(height - 1);
+    }
+
+    out.attribute("lineOrder", "lineOrder", 1);
+    out.u8(0);  // increasing y
+
+    out.attribute("pixelAspectRatio", "float", 4);
+    out.f32(1.0f);
+
+    out.attribute("screenWindowCenter", "v2f", 8);
+    out.f32(0.0f);
+    out.f32(0.0f);
+
+    out.attribute("screenWindowWidth", "float", 4);
+    out.f32(1.0f);
+
+    out.u8(0);  // end of header
+
+    // Offset table: one entry per scanline, then the scanlines themselves,
+    // each holding the B, G and R values for the whole row in turn.
+    auto const line_size = static_cast<std::uint64_t>(width) * EXR_CHANNELS.size() * sizeof(float);
+    auto const table_end = out.data.size() + static_cast<std::size_t>(height) * sizeof(std::uint64_t);
+    for (std::int32_t y = 0; y < height; ++y) {
+        out.u64(table_end + y * (8 + line_size));
+    }
+
+    auto const pixels_start = out.data.size();
+    out.data.resize(pixels_start + height * (8 + line_size));
+    auto * p = out.data.data() + pixels_start;
+    RowReader rows {canvas};
+    for (std::int32_t y = 0; y < height; ++y) {
+        p = store_u32_le(p, static_cast<std::uint32_t>(y));
+        p = store_u32_le(p, static_cast<std::uint32_t>(line_size));
+        auto * b = p;
+        auto * g = b + width * sizeof(float);
+        auto * r = g + width * sizeof(float);
+        for (auto const & c : rows(y)) {
+            b = store_float_le(b, static_cast<float>(c.blue()));
+            g = store_float_le(g, static_cast<float>(c.green()));
+            r = store_float_le(r, static_cast<float>(c.red()));
+        }
+        p += line_size;
+    }
+    return std::move(out.data);
+}
+
+// Little-endian decoding helper
+class ExrReader {
+public:
+    explicit ExrReader(std::vector<char> const & data) : data_{data} {}
+
+    bool ok() const { return ok_; }
+    std::size_t position() const { return pos_; }
+    void seek(std::size_t pos) { pos_ = pos; ok_ = ok_ && pos <= data_.size(); }
+
+    std::uint8_t u8() {
+        if (pos_ >= data_.size()) {
+            ok_ = false;
+            return 0;
+        }
+        return static_cast<std::uint8_t>(data_[pos_++]);
+    }
+
+    std::uint32_t u32() {
+        std::uint32_t v {0};
+        for (int i = 0; i < 4; ++i) {
+            v |= static_cast<std::uint32_t>(u8()) << (8 * i);
+        }
+        return v;
+    }
+
+    std::int32_t i32() { return static_cast<std::int32_t>(u32()); }
+
+    std::uint64_t u64() {
+        std::uint64_t v {0};
+        for (int i = 0; i < 8; ++i) {
+            v |= static_cast<std::uint64_t>(u8()) << (8 * i);
+        }
+        return v;
+    }
+
+    float f32() { return std::bit_cast<float>(u32()); }
+
+    std::string str() {
+        std::string s;
+        while (ok_) {
+            auto const c = u8();
+            if (c == 0) {
+                break;
+            }
+            s.push_back(static_cast<char>(c));
+        }
+        return s;
+    }
+
+private:
+    std::vector<char> const & data_;
+    std::size_t pos_ {0};
+    bool ok_ {true};
+};
+
+} // namespace detail
+
+// Write a canvas to a stream as OpenEXR
+template <typename Canvas>
+std::ostream & write_exr(std::ostream & os, Canvas const & canvas) {
+    auto const exr = detail::exr_from_canvas(canvas);
+    return os.write(exr.data(), static_cast<std::streamsize>(exr.size()));
+}
+
+// Write a canvas to a file descriptor as OpenEXR.  Returns false if the write failed.
+template <typename Canvas>
+bool write_exr(int fd, Canvas const & canvas) {
+    auto const exr = detail::exr_from_canvas(canvas);
+    return detail::FdSink{fd}.write(exr.data(), exr.size());
+}
+
+// Read an uncompressed scanline OpenEXR image with 32-bit float R, G and B channels,
+// such as those written by write_exr().  Returns std::nullopt for anything else.
+inline std::optional<Canvas<Color>> read_exr(std::istream & is) {
+    std::vector<char> const data {std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+    detail::ExrReader in {data};
+
+    if (in.u32() != detail::EXR_MAGIC || (in.u32() & 0xff) != 2) {
+        return std::nullopt;
+    }
+
+    std::vector<std::string> channels;
+    std::array<std::int32_t, 4> window {};
+    std::uint8_t compression {0xff};
+    while (in.ok()) {
+        auto const name = in.str();
+        if (name.empty()) {
+            break;  // end of header
+        }
+        auto const type = in.str();
+        auto const size = in.u32();
+        auto const next = in.position() + size;
+        if (name == "channels") {
+            while (in.ok()) {
+                auto const channel = in.str();
+                if (channel.empty()) {
+                    break;
+                }
+                if (in.i32() != detail::EXR_PIXEL_TYPE_FLOAT) {
+                    return std::nullopt;
+                }
+                in.seek(in.position() + 12);  // pLinear, reserved, sampling
+                channels.push_back(channel);
+            }
+        } else if (name == "compression") {
+            compression = in.u8();
+        } else if (name == "dataWindow") {
+            for (auto & w : window) {
+                w = in.i32();
+            }
+        }
+        in.seek(next);
+    }
+
+    auto const width = window[2] - window[0] + 1;
+    auto const height = window[3] - window[1] + 1;
+    if (!in.ok() || compression != detail::EXR_NO_COMPRESSION || width <= 0 || height <= 0) {
+        return std::nullopt;
+    }
+
+    auto const channel_index = [&](std::string const & name) -> int {
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            if (channels[i] == name) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    };
+    auto const r = channel_index("R");
+    auto const g = channel_index("G");
+    auto const b = channel_index("B");
+    if (r < 0 || g < 0 || b < 0) {
+        return std::nullopt;
+    }
+
+    std::vector<std::uint64_t> offsets(height);
+    for (auto & offset : offsets) {
+        offset = in.u64();
+    }
+
+    Canvas<Color> image {static_cast<unsigned int>(width), static_cast<unsigned int>(height)};
+    std::vector<float> line(static_cast<std::size_t>(width) * channels.size());
+    for (auto const offset : offsets) {
+        in.seek(offset);
+        auto const y = in.i32() - window[1];
+        auto const size = in.u32();
+        if (!in.ok() || y < 0 || y >= height || size != line.size() * sizeof(float)) {
+            return std::nullopt;
+        }
+        for (auto & v : line) {
+            v = in.f32();
+        }
+        for (std::int32_t x = 0; x < width; ++x) {
+            image.write_pixel(x, y, Color {line[r * width + x], line[g * width + x], line[b * width + x]});
+        }
+    }
+    if (!in.ok()) {
+        return std::nullopt;
+    }
+    return image;
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_EXR_H
@@ -2,6 +2,7 @@
 #define RTC_LIB_INTERSECTIONS_H
 
 #include "./math.h"
+#include "profiling.h"
 #include "rays.h"
 #include "shapes.h"
 
@@ -55,6 +56,8 @@ auto intersections(Head&& head, Tail&&... tail) {
 
 inline Intersections intersect(Shape const & shape,
                                Ray const & ray) {
+    ObjectTimer const timer {shape, ObjectPhase::intersection};
+
     // Apply the inverse of the shape's transformation
     auto const local_ray = transform(ray, inverse(shape.transform()));
 
@@ -0,0 +1,113 @@
+// Memory-mapped canvas
+//
+// Stores Rgb32f pixels in a file mapped into memory, so a canvas can be far
+// larger than RAM: pixels are written through the page cache and the kernel
+// writes back and evicts pages as the render progresses.
+//
+// The file is a little-endian colour PFM image (rows bottom to top), so once
+// rendering is done it can be used directly with no further copy.  The scale
+// field in the header is padded with zeros so that the pixel data starts on a
+// float boundary.
+
+#ifndef RTC_LIB_MAPPED_CANVAS_H
+#define RTC_LIB_MAPPED_CANVAS_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "canvas.h"
+#include "pixel_view.h"
+#include "pixels.h"
+
+namespace rtc {
+
+class MappedPfmStorage {
+public:
+    using pixel_t = Rgb32f;
+
+    MappedPfmStorage() = default;
+    MappedPfmStorage(MappedPfmStorage && other) noexcept;
+    MappedPfmStorage & operator=(MappedPfmStorage && other) noexcept;
+    MappedPfmStorage(MappedPfmStorage const &) = delete;
+    MappedPfmStorage & operator=(MappedPfmStorage const &) = delete;
+    ~MappedPfmStorage();
+
+    // Create (or truncate) a width x height PFM file at `path` and map it.
+    // All pixels start out black.
+    static std::optional<MappedPfmStorage> create(std::string const & path, unsigned int width, unsigned int height);
+
+    // Map an existing colour PFM file for reading and writing.  Fails if the file
+    // is not little-endian or its pixel data is not aligned to a float boundary.
+    static std::optional<MappedPfmStorage> open(std::string const & path);
+
+    unsigned int width() const { return width_; }
+    unsigned int height() const { return height_; }
+
+    Rgb32f & at(unsigned int x, unsigned int y) {
+        return pixels_[x + static_cast<std::size_t>(height_ - 1 - y) * width_];
+    }
+
+    Rgb32f const & at(unsigned int x, unsigned int y) const {
+        return pixels_[x + static_cast<std::size_t>(height_ - 1 - y) * width_];
+    }
+
+    // Rows are stored bottom to top, so the view starts at the last row in the
+    // file and steps backwards
+    PixelView<Rgb32f> view() {
+        return {pixels_ + static_cast<std::ptrdiff_t>(height_ - 1) * width_, width_, height_,
+                -static_cast<std::ptrdiff_t>(width_)};
+    }
+
+    PixelView<Rgb32f const> view() const {
+        return {pixels_ + static_cast<std::ptrdiff_t>(height_ - 1) * width_, width_, height_,
+                -static_cast<std::ptrdiff_t>(width_)};
+    }
+
+    // Write all modified pages back to the file, waiting for completion
+    bool sync();
+
+    // Start writing back canvas rows [first, last) and drop them from this
+    // process's address space; they are reloaded from the file if touched again.
+    // Use once a band of rows is finished to keep resident memory bounded.
+    bool release_rows(unsigned int first, unsigned int last);
+
+private:
+    MappedPfmStorage(int fd, void * map, std::size_t map_size, std::size_t data_offset,
+                     unsigned int width, unsigned int height);
+
+    void close_();
+
+    int fd_ {-1};
+    void * map_ {};
+    std::size_t map_size_ {};
+    Rgb32f * pixels_ {};
+    unsigned int width_ {};
+    unsigned int height_ {};
+};
+
+using MappedCanvas = Canvas<Rgb32f, MappedPfmStorage>;
+
+// Create a width x height canvas backed by a PFM file at `path`
+inline std::optional<MappedCanvas> mapped_canvas(std::string const & path, unsigned int width, unsigned int height) {
+    auto storage = MappedPfmStorage::create(path, width, height);
+    if (!storage) {
+        return std::nullopt;
+    }
+    return MappedCanvas {width, height, std::move(*storage)};
+}
+
+// Open an existing PFM file, such as one created by mapped_canvas(), as a canvas
+inline std::optional<MappedCanvas> open_mapped_canvas(std::string const & path) {
+    auto storage = MappedPfmStorage::open(path);
+    if (!storage) {
+        return std::nullopt;
+    }
+    auto const width = storage->width();
+    auto const height = storage->height();
+    return MappedCanvas {width, height, std::move(*storage)};
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_MAPPED_CANVAS_H
@@ -10,6 +10,7 @@
 #include <boost/format.hpp>
 
 #include "./math.h"
+#include "stats.h"
 #include "tuples.h"
 
 namespace rtc {
@@ -276,6 +277,7 @@ inline bool is_invertible(Matrix<N> const & m) {
 
 template <unsigned int N>
 inline auto inverse(Matrix<N> const & m) {
+    count_stat<&RenderStats::matrix_inversions>();
     auto const det = determinant(m);
 
     Matrix<N> m2;
@@ -0,0 +1,183 @@
+// Precomputed Perlin Noise volume
+//
+// Bakes octave_perlin() into a 3D grid once, then serves lookups by trilinear
+// interpolation.  This trades accuracy for speed: a lookup touches 8 grid values
+// regardless of the number of octaves.
+//
+// A volume either holds PerlinNoise(period), which repeats, over one period and
+// tiles it; or the non-repeating PerlinNoise() over a bounded box, which is
+// what PerturbedPattern evaluates.
+
+#ifndef RTC_LIB_NOISE_VOLUME_H
+#define RTC_LIB_NOISE_VOLUME_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "math.h" // NOLINT(modernize-deprecated-headers)
+#include "perlin_noise.h"
+#include "tuples.h"
+
+namespace rtc {
+
+class NoiseVolume {
+public:
+    // Bake PerlinNoise(period).octave_perlin(..., num_octaves, persistence) over the
+    // cube [0, period)^3, sampled at `resolution` points along each axis.
+    //
+    // The noise repeats every `period` units in x, y and z, so lookups outside the
+    // cube wrap around without seams.  Memory use is resolution^3 floats.  A
+    // resolution of 0 is taken as 1.
+    NoiseVolume(int period, unsigned int resolution, int num_octaves, fp_t persistence) :
+        period_{period},
+        resolution_{std::max(resolution, 1U)},
+        num_octaves_{num_octaves},
+        persistence_{persistence},
+        points_{resolution_},
+        origin_{0.0, 0.0, 0.0},
+        grid_scale_{repeat_(static_cast<fp_t>(resolution_) / period)},
+        values_(static_cast<std::size_t>(points_) * points_ * points_) {
+        bake_();
+    }
+
+    // Bake PerlinNoise().octave_perlin(..., num_octaves, persistence), which does
+    // not repeat, over the box [min, max], sampled at `resolution` + 1 points
+    // along each axis (both faces included).
+    //
+    // Lookups outside the box are clamped to its faces; use contains() to tell
+    // whether a point is covered.  Memory use is (resolution + 1)^3 floats.  A
+    // resolution of 0 is taken as 1, and along an axis where the box is flat
+    // (max <= min) every lookup takes the value at min.
+    NoiseVolume(Point const & min, Point const & max, unsigned int resolution, int num_octaves, fp_t persistence) :
+        period_{0},
+        resolution_{std::max(resolution, 1U)},
+        num_octaves_{num_octaves},
+        persistence_{persistence},
+        points_{resolution_ + 1},
+        origin_{min.x(), min.y(), min.z()},
+        max_{max.x(), max.y(), max.z()},
+        grid_scale_{bounded_scale_(resolution_, min.x(), max.x()), bounded_scale_(resolution_, min.y(), max.y()),
+                    bounded_scale_(resolution_, min.z(), max.z())},
+        values_(static_cast<std::size_t>(points_) * points_ * points_) {
+        bake_();
+    }
+
+    auto period() const { return period_; }     // 0 for a bounded volume
+    auto resolution() const { return resolution_; }
+    auto num_octaves() const { return num_octaves_; }
+    auto persistence() const { return persistence_; }
+
+    // Whether (x, y, z) is within the baked noise; always true for a periodic volume
+    bool contains(fp_t x, fp_t y, fp_t z) const {
+        return period_ > 0 || (x >= origin_[0] && x <= max_[0] && y >= origin_[1] && y <= max_[1] &&
+                               z >= origin_[2] && z <= max_[2]);
+    }
+
+    // Approximates octave_perlin(x, y, z, num_octaves, persistence) of the baked noise
+    fp_t sample(fp_t x, fp_t y, fp_t z) const {
+        auto const cx = cell_(x, 0);
+        auto const cy = cell_(y, 1);
+        auto const cz = cell_(z, 2);
+
+        auto const c00 = lerp_x_(cx, cy.i0, cz.i0);
+        auto const c10 = lerp_x_(cx, cy.i1, cz.i0);
+        auto const c01 = lerp_x_(cx, cy.i0, cz.i1);
+        auto const c11 = lerp_x_(cx, cy.i1, cz.i1);
+
+        using detail::lerp;
+        return lerp(lerp(c00, c10, cy.f), lerp(c01, c11, cy.f), cz.f);
+    }
+
+    // Approximates PerlinNoise::octave_perlin3(), i.e. sample() at z, z + 1 and z + 2
+    std::array<fp_t, 3> sample3(fp_t x, fp_t y, fp_t z) const {
+        return {sample(x, y, z), sample(x, y, z + 1.0), sample(x, y, z + 2.0)};
+    }
+
+private:
+    // Lower and upper grid index along one axis, and the fraction between them
+    struct Cell {
+        std::size_t i0 {};
+        std::size_t i1 {};
+        fp_t f {};
+    };
+
+    static std::array<fp_t, 3> repeat_(fp_t v) { return {v, v, v}; }
+
+    // Grid points per unit between lo and hi; 0 when the extent is empty
+    static fp_t bounded_scale_(unsigned int resolution, fp_t lo, fp_t hi) {
+        return hi > lo ? resolution / (hi - lo) : fp_t {0};
+    }
+
+    Cell cell_(fp_t v, std::size_t axis) const {
+        auto const g = (v - origin_[axis]) * grid_scale_[axis];
+        if (period_ == 0) {
+            auto const clamped = std::clamp(g, fp_t {0}, static_cast<fp_t>(resolution_));
+            auto const i0 = std::min(static_cast<std::size_t>(clamped), static_cast<std::size_t>(resolution_ - 1));
+            return {i0, i0 + 1, clamped - static_cast<fp_t>(i0)};
+        }
+        auto const fg = std::floor(g);
+        auto i = static_cast<long>(fg) % static_cast<long>(resolution_);
+        if (i < 0) {
+            i += resolution_;
+        }
+        auto const i0 = static_cast<std::size_t>(i);
+        auto const i1 = i0 + 1 == resolution_ ? 0 : i0 + 1;
+        return {i0, i1, g - fg};
+    }
+
+    std::size_t index_(std::size_t x, std::size_t y, std::size_t z) const {
+        return (z * points_ + y) * points_ + x;
+    }
+
+    fp_t lerp_x_(Cell const & cx, std::size_t y, std::size_t z) const {
+        fp_t const a = values_[index_(cx.i0, y, z)];
+        fp_t const b = values_[index_(cx.i1, y, z)];
+        return detail::lerp(a, b, cx.f);
+    }
+
+    void bake_() {
+        PerlinNoise const noise {period_ > 0 ? period_ : -1};
+        auto const position = [&](unsigned int i, std::size_t axis) {
+            return grid_scale_[axis] > 0 ? origin_[axis] + i / grid_scale_[axis] : origin_[axis];
+        };
+
+        // One row of x values at a time, through the batch evaluator
+        std::vector<fp_t> xs(points_), ys(points_), zs(points_), row(points_);
+        for (auto i = 0U; i < points_; ++i) {
+            xs[i] = position(i, 0);
+        }
+
+        for (auto z = 0U; z < points_; ++z) {
+            for (auto y = 0U; y < points_; ++y) {
+                std::fill(ys.begin(), ys.end(), position(y, 1));
+                std::fill(zs.begin(), zs.end(), position(z, 2));
+                noise.octave_perlin_batch(xs.data(), ys.data(), zs.data(), row.data(), row.size(),
+                                          num_octaves_, persistence_);
+                std::copy(row.begin(), row.end(), values_.begin() + index_(0, y, z));
+            }
+        }
+    }
+
+private:
+    int period_ {};
+    unsigned int resolution_ {};
+    int num_octaves_ {};
+    fp_t persistence_ {};
+    unsigned int points_ {};            // grid points along each axis
+    std::array<fp_t, 3> origin_ {};
+    std::array<fp_t, 3> max_ {};        // bounded volumes only
+    std::array<fp_t, 3> grid_scale_ {}; // grid points per unit
+
+    std::vector<float> values_ {};
+};
+
+inline auto noise_volume(int period, unsigned int resolution, int num_octaves, fp_t persistence) {
+    return NoiseVolume {period, resolution, num_octaves, persistence};
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_NOISE_VOLUME_H
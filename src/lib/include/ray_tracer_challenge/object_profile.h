@@ -0,0 +1,149 @@
+// Per-object cost attribution
+//
+// A profiled render (in a build with RTC_ENABLE_PROFILING, see profiling.h)
+// charges the time spent on intersection tests, shading and pattern lookups
+// to the shape each was for.  The report ranks the world's shapes by their
+// total, to show which objects and materials are worth simplifying.
+
+#ifndef RTC_LIB_OBJECT_PROFILE_H
+#define RTC_LIB_OBJECT_PROFILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "patterns.h"
+#include "planes.h"
+#include "profiling.h"
+#include "render.h"
+#include "spheres.h"
+#include "world.h"
+
+namespace rtc {
+
+class ObjectProfile {
+public:
+    ObjectCosts const & costs() const { return costs_; }
+
+    ObjectCost cost(Shape const & shape) const {
+        auto const it = costs_.find(&shape);
+        return it != costs_.end() ? it->second : ObjectCost {};
+    }
+
+    void merge(ObjectCosts const & costs) {
+        for (auto const & [shape, cost] : costs) {
+            costs_[shape] += cost;
+        }
+    }
+
+private:
+    ObjectCosts costs_ {};
+};
+
+// Render as render(camera, world, image, options) does, also adding each
+// shape's costs to `profile`.  Timing every intersection test makes the
+// render several times slower, but the shares of the total stay useful.
+// Without RTC_ENABLE_PROFILING the profile is left as it was.  Returns
+// nothing, and renders nothing, if the canvas is smaller than hsize x vsize.
+template <typename Canvas>
+std::optional<RenderStats> render(Camera const & camera, World const & world, Canvas & image,
+                                  ObjectProfile & profile, RenderOptions const & options) {
+    if (!detail::covers(camera, image)) {
+        return std::nullopt;
+    }
+    std::mutex profile_mutex;
+    return detail::render_tiles<Canvas>(camera, options, [&](auto const & tile) {
+        ObjectCosts tile_costs;
+        detail::thread_object_costs = &tile_costs;
+        detail::render_tile(camera, world, image, tile);
+        detail::thread_object_costs = nullptr;
+        std::lock_guard const lock {profile_mutex};
+        profile.merge(tile_costs);
+    });
+}
+
+struct RankedObject {
+    std::size_t index {};           // in world.objects()
+    Shape const * shape {};
+    ObjectCost cost {};
+};
+
+// The world's shapes, most expensive first
+inline std::vector<RankedObject> rank_objects(World const & world, ObjectProfile const & profile) {
+    std::vector<RankedObject> ranked;
+    for (std::size_t i = 0; i < world.objects().size(); ++i) {
+        auto const & shape = *world.objects()[i];
+        ranked.push_back(RankedObject {i, &shape, profile.cost(shape)});
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](auto const & a, auto const & b) {
+        return a.cost.total_ns() > b.cost.total_ns();
+    });
+    return ranked;
+}
+
+namespace detail {
+
+inline std::string pattern_name(Pattern const * pattern) {
+    if (!pattern) return "none";
+    if (dynamic_cast<SolidPattern const *>(pattern)) return "solid";
+    if (dynamic_cast<StripePattern const *>(pattern)) return "stripes";
+    if (dynamic_cast<GradientPattern const *>(pattern)) return "gradient";
+    if (dynamic_cast<RingPattern const *>(pattern)) return "rings";
+    if (dynamic_cast<CheckersPattern const *>(pattern)) return "checkers";
+    if (dynamic_cast<RadialGradientPattern const *>(pattern)) return "radial gradient";
+    if (dynamic_cast<BlendedPattern const *>(pattern)) return "blended";
+    if (dynamic_cast<PerturbedPattern const *>(pattern)) return "perturbed";
+    return "other";
+}
+
+inline std::string shape_name(Shape const & shape) {
+    if (dynamic_cast<Sphere const *>(&shape)) return "sphere";
+    if (dynamic_cast<Plane const *>(&shape)) return "plane";
+    return "shape";
+}
+
+} // namespace detail
+
+// Print the ranked shapes as a table: each shape's total time and share of the
+// profiled time, then its time in each phase and the number of intersection
+// tests.  Times are in milliseconds, summed over all threads.
+inline void write_object_report(std::ostream & os, World const & world, ObjectProfile const & profile) {
+    auto const ranked = rank_objects(world, profile);
+    std::uint64_t total_ns {0};
+    for (auto const & object : ranked) {
+        total_ns += object.cost.total_ns();
+    }
+    auto const ms = [](std::uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+
+    auto const flags = os.flags();
+    auto const precision = os.precision();
+    os << std::left << std::setw(6) << "rank" << std::setw(8) << "object" << std::setw(8) << "shape"
+       << std::setw(17) << "pattern" << std::right << std::setw(11) << "total ms" << std::setw(8) << "share"
+       << std::setw(13) << "intersect ms" << std::setw(11) << "shade ms" << std::setw(12) << "pattern ms"
+       << std::setw(12) << "tests" << "\n";
+    os << std::fixed;
+    for (std::size_t rank = 0; rank < ranked.size(); ++rank) {
+        auto const & [index, shape, cost] = ranked[rank];
+        auto const share = total_ns > 0 ? 100.0 * static_cast<double>(cost.total_ns()) / static_cast<double>(total_ns)
+                                        : 0.0;
+        os << std::left << std::setw(6) << rank + 1 << std::setw(8) << index << std::setw(8)
+           << detail::shape_name(*shape) << std::setw(17) << detail::pattern_name(shape->material().pattern())
+           << std::right << std::setprecision(2) << std::setw(11) << ms(cost.total_ns())
+           << std::setprecision(1) << std::setw(7) << share << "%"
+           << std::setprecision(2) << std::setw(13) << ms(cost.ns(ObjectPhase::intersection))
+           << std::setw(11) << ms(cost.ns(ObjectPhase::shading))
+           << std::setw(12) << ms(cost.ns(ObjectPhase::pattern))
+           << std::setw(12) << cost.count(ObjectPhase::intersection) << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_OBJECT_PROFILE_H
@@ -1,9 +1,13 @@
 #ifndef RTC_LIB_PATTERNS_H
 #define RTC_LIB_PATTERNS_H
 
+#include <memory>
+
 #include "color.h"
 #include "matrices.h"
 #include "perlin_noise.h"
+#include "simplex_noise.h"
+#include "noise_volume.h"
 
 namespace rtc {
 
@@ -303,21 +307,30 @@ inline auto blended_pattern(A const & a, B const & b) {
 }
 
 
+// Noise generator used to perturb a pattern
+enum class NoiseType {
+    perlin,
+    simplex,
+};
+
 class PerturbedPattern : public NestedPattern<PerturbedPattern> {
 public:
     using NestedPattern<PerturbedPattern>::NestedPattern;
 
     template <typename A>
-    PerturbedPattern(A const & a, fp_t scale = 0.5, int num_octaves = 1, fp_t persistence = 0.9)
+    PerturbedPattern(A const & a, fp_t scale = 0.5, int num_octaves = 1, fp_t persistence = 0.9,
+                     NoiseType noise_type = NoiseType::perlin)
             : NestedPattern<PerturbedPattern> {a},
               scale_{scale},
               num_octaves_{num_octaves},
-              persistence_{persistence} {}
+              persistence_{persistence},
+              noise_type_{noise_type} {}
 
     Color pattern_at(Point const & local_point) const override {
-        auto new_x = local_point.x() + perlin_noise_.octave_perlin(local_point.x(), local_point.y(), local_point.z(), num_octaves_, persistence_) * scale_;
-        auto new_y = local_point.y() + perlin_noise_.octave_perlin(local_point.x(), local_point.y(), local_point.z() + 1.0, num_octaves_, persistence_) * scale_;
-        auto new_z = local_point.z() + perlin_noise_.octave_perlin(local_point.x(), local_point.y(), local_point.z() + 2.0, num_octaves_, persistence_) * scale_;
+        auto const noise = noise_at(local_point);
+        auto new_x = local_point.x() + noise[0] * scale_;
+        auto new_y = local_point.y() + noise[1] * scale_;
+        auto new_z = local_point.z() + noise[2] * scale_;
         auto perturbed_point = point(new_x, new_y, new_z);
 
         auto const pattern_point_a {inverse(this->a_->transform()) * perturbed_point};
@@ -325,19 +338,60 @@ public:
         return color_a;
     }
 
+    auto noise_type() const { return noise_type_; }
+
+    // Opt-in: replace per-point noise evaluation with lookups into the pattern's
+    // own noise, baked over the box [min, max] of pattern space at `resolution`
+    // points per axis.  Only the precision changes; points outside the box still
+    // evaluate the noise.  Copies of this pattern share the baked volume.
+    //
+    // Returns false, and bakes nothing, for simplex noise, which a NoiseVolume
+    // cannot hold, for a resolution of 0, or for a box that is empty or flat
+    // along any axis.
+    bool bake_noise(Point const & min, Point const & max, unsigned int resolution = 128) {
+        if (noise_type_ != NoiseType::perlin || resolution == 0 ||
+            !(max.x() > min.x() && max.y() > min.y() && max.z() > min.z())) {
+            return false;
+        }
+        // The second and third components are the noise at z + 1 and z + 2
+        noise_volume_ = std::make_shared<NoiseVolume const>(min, point(max.x(), max.y(), max.z() + 2.0),
+                                                            resolution, num_octaves_, persistence_);
+        return true;
+    }
+
+    auto const * noise_volume() const { return noise_volume_.get(); }
+
+    // The three perturbation components, equivalent to octave noise at z, z + 1 and z + 2
+    std::array<fp_t, 3> noise_at(Point const & p) const {
+        count_stat<&RenderStats::noise_evaluations>();
+        if (noise_volume_ && noise_volume_->contains(p.x(), p.y(), p.z() + 2.0) &&
+            noise_volume_->contains(p.x(), p.y(), p.z())) {
+            return noise_volume_->sample3(p.x(), p.y(), p.z());
+        }
+        if (noise_type_ == NoiseType::simplex) {
+            return simplex_noise_.octave_simplex3(p.x(), p.y(), p.z(), num_octaves_, persistence_);
+        }
+        // One fused noise evaluation for all three components
+        return perlin_noise_.octave_perlin3(p.x(), p.y(), p.z(), num_octaves_, persistence_);
+    }
+
 private:
     PerlinNoise perlin_noise_ {};
+    SimplexNoise simplex_noise_ {};
+    std::shared_ptr<NoiseVolume const> noise_volume_ {};
 
     fp_t scale_ {0.5};
     int num_octaves_ {1};
     fp_t persistence_ {0.9};
+    NoiseType noise_type_ {NoiseType::perlin};
 };
 
 inline auto perturbed_pattern(Pattern const & pattern,
                               fp_t scale = 1.0,
                               int num_octaves = 1,
-                              fp_t persistence = 0.9) {
-    return PerturbedPattern {pattern, scale, num_octaves, persistence};
+                              fp_t persistence = 0.9,
+                              NoiseType noise_type = NoiseType::perlin) {
+    return PerturbedPattern {pattern, scale, num_octaves, persistence, noise_type};
 }
 
 // TODO: Spherical Texture Mapping - Page 138
@@ -0,0 +1,76 @@
+// Hardware performance counters
+//
+// Reads the CPU's cycle, instruction, cache miss and branch miss counters
+// through Linux's perf_event_open(2), for the calling thread and any threads
+// it starts while counting (such as the workers of parallel_for).  Only user
+// space is counted.
+//
+// Counters are often unavailable: on other systems, in virtual machines that
+// do not pass the PMU through, or when kernel.perf_event_paranoid forbids
+// them.  Each counter that could not be opened reads as std::nullopt, and
+// everything else carries on as usual.
+
+#ifndef RTC_LIB_PERF_COUNTERS_H
+#define RTC_LIB_PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace rtc {
+
+struct PerfCounts {
+    std::optional<std::uint64_t> cycles {};
+    std::optional<std::uint64_t> instructions {};
+    std::optional<std::uint64_t> cache_misses {};      // last level cache
+    std::optional<std::uint64_t> branch_misses {};
+
+    // Instructions per cycle, if both were counted
+    std::optional<double> ipc() const {
+        if (cycles && instructions && *cycles > 0) {
+            return static_cast<double>(*instructions) / static_cast<double>(*cycles);
+        }
+        return std::nullopt;
+    }
+};
+
+class PerfCounters {
+public:
+    // Opens the counters, stopped
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(PerfCounters const &) = delete;
+    PerfCounters & operator=(PerfCounters const &) = delete;
+
+    // Whether any counter could be opened
+    bool available() const;
+
+    // Zero the counters and start counting
+    void start();
+
+    // Stop counting, and return the counts since start()
+    PerfCounts stop();
+
+    // The counts so far, without stopping.  If the kernel had to share the
+    // hardware between more counters than it has, the counts are scaled up
+    // from the time each one was actually counting.
+    PerfCounts read() const;
+
+    // What the kernel reports for each counter
+    struct Reading {
+        std::uint64_t value;
+        std::uint64_t time_enabled;
+        std::uint64_t time_running;
+    };
+
+private:
+    static constexpr std::size_t NUM_COUNTERS {4};
+
+    std::array<int, NUM_COUNTERS> fds_ {};      // -1 where unavailable
+    std::array<Reading, NUM_COUNTERS> start_ {};
+};
+
+} // namespace rtc
+
+#endif // RTC_LIB_PERF_COUNTERS_H
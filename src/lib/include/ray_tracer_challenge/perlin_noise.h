@@ -7,6 +7,7 @@
 #define RTC_LIB_PERLIN_NOISE_H
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
 #include <optional>
@@ -84,14 +85,40 @@ inline double grad(int hash, double x, double y, double z) {
     return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
 }
 
-inline double fade(double t) {
+// The 16 gradient directions selected by grad() above, as a table.  Each entry is the
+// (x, y, z) coefficient of the dot product, so the same result can be computed without
+// branching on the hash - this is what allows the batch functions to vectorise.
+static constexpr std::array<int_fast8_t, 16> GRADIENT_X = { 1, -1,  1, -1,  1, -1,  1, -1,  0,  0,  0,  0,  1,  0, -1,  0};
+static constexpr std::array<int_fast8_t, 16> GRADIENT_Y = { 1,  1, -1, -1,  0,  0,  0,  0,  1, -1,  1, -1,  1, -1,  1, -1};
+static constexpr std::array<int_fast8_t, 16> GRADIENT_Z = { 0,  0,  0,  0,  1,  1, -1, -1,  1,  1, -1, -1,  0,  1,  0, -1};
+
+// Branchless equivalent of grad()
+template <typename T>
+inline T grad_branchless(int hash, T x, T y, T z) {
+    int const h = hash & 15;
+    return static_cast<T>(GRADIENT_X[h]) * x
+         + static_cast<T>(GRADIENT_Y[h]) * y
+         + static_cast<T>(GRADIENT_Z[h]) * z;
+}
+
+// Branch-free floor() for |x| < 2^31.  Unlike std::floor this does not require SSE4.1
+// to vectorise, so the batch functions use it.
+template <typename T>
+inline T fast_floor(T x) {
+    T const t = static_cast<T>(static_cast<int>(x));
+    return t > x ? t - 1 : t;
+}
+
+template <typename T>
+inline T fade(T t) {
     // Fade function as defined by Ken Perlin.  This eases coordinate values
     // so that they will "ease" towards integral values.  This ends up smoothing
     // the final output.
     return t * t * t * (t * (t * 6 - 15) + 10);  // 6t^5 - 15t^4 + 10t^3
 }
 
-inline double lerp(double a, double b, double x) {
+template <typename T>
+inline T lerp(T a, T b, T x) {
     return a + x * (b - a);
 }
 
@@ -181,7 +208,282 @@ public:
         return total / max_value;
     }
 
+    // Fused evaluation of octave_perlin() at (x, y, z), (x, y, z + 1) and (x, y, z + 2).
+    //
+    // Each octave scales the offsets by a whole number, so the three points share
+    // x and y entirely and z's fraction; only their z cell differs.  The lattice
+    // work for x and y (floor, fade, the first two levels of permutation lookups)
+    // is done once per octave, and so is z's floor and fade.  Each z lattice plane
+    // is reduced to two bilinear sums over its four corners, one for the x and y
+    // part of the gradient dot products and one for the z gradients.  In the
+    // first octave the three cells are adjacent and four planes serve them all;
+    // later octaves need six, against two for a single octave_perlin().  In
+    // BM_octave_perlin3 this costs about 1.8 octave_perlin() calls for one
+    // octave and 1.45 for four.  Results match octave_perlin() to rounding.
+    inline std::array<double, 3> octave_perlin3(double x, double y, double z, int octaves, double persistence) const {
+        std::array<double, 3> total {};
+        double frequency = 1;
+        double amplitude = 1;
+        double max_value = 0;
+
+        for(int i = 0; i < octaves; ++i) {
+            auto const noise = perlin3_(x * frequency, y * frequency, z * frequency, frequency);
+            for (int c = 0; c < 3; ++c) {
+                total[c] += noise[c] * amplitude;
+            }
+            max_value += amplitude;
+            amplitude *= persistence;
+            frequency *= 2;
+        }
+
+        for (auto & t : total) {
+            t /= max_value;
+        }
+        return total;
+    }
+
+    // Evaluate perlin() for n points at once: out[i] = perlin(xs[i], ys[i], zs[i]).
+    //
+    // Points are processed in blocks of `Lanes` (4, 8 or 16) with the hashing, fading and
+    // gradient selection written as fixed-length, branch-free loops over the block so the
+    // compiler can vectorise them.  Use T = float for the faster, lower precision path;
+    // results match perlin() to within about 1e-4 for moderate coordinates.
+    template <unsigned int Lanes = 8, typename T = double>
+    void perlin_batch(T const * xs, T const * ys, T const * zs, T * out, std::size_t n) const {
+        for_each_block_<Lanes>(xs, ys, zs, out, n,
+                               [this](T const * x, T const * y, T const * z, T * o) {
+                                   perlin_block_<Lanes>(x, y, z, o);
+                               });
+    }
+
+    // Evaluate octave_perlin() for n points at once.
+    template <unsigned int Lanes = 8, typename T = double>
+    void octave_perlin_batch(T const * xs, T const * ys, T const * zs, T * out, std::size_t n,
+                             int octaves, T persistence) const {
+        for_each_block_<Lanes>(xs, ys, zs, out, n,
+                               [this, octaves, persistence](T const * x, T const * y, T const * z, T * o) {
+                                   octave_perlin_block_<Lanes>(x, y, z, o, octaves, persistence);
+                               });
+    }
+
 private:
+    // perlin() at (x, y, z), (x, y, z + step) and (x, y, z + 2 * step), for a
+    // whole number `step`
+    inline std::array<double, 3> perlin3_(double x, double y, double z, double step) const {
+        if (repeat_ > 0) {
+            x = std::fmod(x, repeat_);
+            y = std::fmod(y, repeat_);
+        }
+
+        double const fx {detail::fast_floor(x)};
+        double const fy {detail::fast_floor(y)};
+        int const xi {static_cast<int>(fx) & 255};
+        int const yi {static_cast<int>(fy) & 255};
+        double const xf {x - fx};
+        double const yf {y - fy};
+        double const u {detail::fade(xf)};
+        double const v {detail::fade(yf)};
+
+        auto const & p {detail::PERMUTATION};
+        int const aa {p[p[    xi ]+    yi ]};
+        int const ab {p[p[    xi ]+inc(yi)]};
+        int const ba {p[p[inc(xi)]+    yi ]};
+        int const bb {p[p[inc(xi)]+inc(yi)]};
+
+        // The lower and upper z lattice planes of each point, and its faded
+        // fraction between them.  Without a repeat the fraction is the same for
+        // all three.
+        std::array<int, 3> zlo {}, zhi {};
+        std::array<double, 3> zf {}, w {};
+        if (repeat_ > 0) {
+            for (int c = 0; c < 3; ++c) {
+                double const zc {std::fmod(z + c * step, repeat_)};
+                double const fz {detail::fast_floor(zc)};
+                zlo[c] = static_cast<int>(fz) & 255;
+                zhi[c] = inc(zlo[c]);
+                zf[c] = zc - fz;
+                w[c] = detail::fade(zf[c]);
+            }
+        } else {
+            double const fz {detail::fast_floor(z)};
+            auto const z0 = static_cast<int>(fz);
+            auto const dz = static_cast<int>(step);
+            double const f {z - fz};
+            double const fw {detail::fade(f)};
+            for (int c = 0; c < 3; ++c) {
+                zlo[c] = (z0 + c * dz) & 255;
+                zhi[c] = zlo[c] + 1;
+                zf[c] = f;
+                w[c] = fw;
+            }
+        }
+
+        // A plane's contribution at height t above it is xy + t * dz: the
+        // bilinear sums of its corners' x and y dot products and z gradients
+        struct Plane {
+            double xy;
+            double dz;
+        };
+        auto const plane = [&](int zi) {
+            using namespace detail;
+            int const h00 {p[aa + zi] & 15};
+            int const h10 {p[ba + zi] & 15};
+            int const h01 {p[ab + zi] & 15};
+            int const h11 {p[bb + zi] & 15};
+            double const xy = lerp(lerp(GRADIENT_X[h00] * xf + GRADIENT_Y[h00] * yf,
+                                        GRADIENT_X[h10] * (xf - 1) + GRADIENT_Y[h10] * yf, u),
+                                   lerp(GRADIENT_X[h01] * xf + GRADIENT_Y[h01] * (yf - 1),
+                                        GRADIENT_X[h11] * (xf - 1) + GRADIENT_Y[h11] * (yf - 1), u),
+                                   v);
+            double const dz = lerp(lerp<double>(GRADIENT_Z[h00], GRADIENT_Z[h10], u),
+                                   lerp<double>(GRADIENT_Z[h01], GRADIENT_Z[h11], u), v);
+            return Plane {xy, dz};
+        };
+
+        std::array<double, 3> result {};
+        Plane upper {};
+        for (int c = 0; c < 3; ++c) {
+            // In the first octave each point's lower plane is the previous one's upper
+            Plane const lower = c > 0 && zlo[c] == (zhi[c - 1] & 255) ? upper : plane(zlo[c]);
+            upper = plane(zhi[c]);
+            double const at_lower {lower.xy + zf[c] * lower.dz};
+            double const at_upper {upper.xy + (zf[c] - 1) * upper.dz};
+            result[c] = (detail::lerp(at_lower, at_upper, w[c]) + 1.0) / 2.0;
+        }
+        return result;
+    }
+
+    // Split n points into full blocks of Lanes, padding the final partial block.
+    template <unsigned int Lanes, typename T, typename BlockFn>
+    static void for_each_block_(T const * xs, T const * ys, T const * zs, T * out, std::size_t n,
+                                BlockFn && block_fn) {
+        static_assert(Lanes == 4 || Lanes == 8 || Lanes == 16, "Lanes must be 4, 8 or 16");
+
+        std::size_t i = 0;
+        for (; i + Lanes <= n; i += Lanes) {
+            block_fn(xs + i, ys + i, zs + i, out + i);
+        }
+
+        if (i < n) {
+            std::array<T, Lanes> x {}, y {}, z {}, o {};
+            auto const remaining = n - i;
+            for (std::size_t l = 0; l < remaining; ++l) {
+                x[l] = xs[i + l];
+                y[l] = ys[i + l];
+                z[l] = zs[i + l];
+            }
+            block_fn(x.data(), y.data(), z.data(), o.data());
+            for (std::size_t l = 0; l < remaining; ++l) {
+                out[i + l] = o[l];
+            }
+        }
+    }
+
+    template <unsigned int Lanes, typename T>
+    void perlin_block_(T const * xs, T const * ys, T const * zs, T * out) const {
+        std::array<T, Lanes> x, y, z;
+        for (unsigned int l = 0; l < Lanes; ++l) {
+            x[l] = xs[l];
+            y[l] = ys[l];
+            z[l] = zs[l];
+        }
+
+        if (repeat_ > 0) {
+            auto const r = static_cast<T>(repeat_);
+            for (unsigned int l = 0; l < Lanes; ++l) {
+                x[l] = std::fmod(x[l], r);
+                y[l] = std::fmod(y[l], r);
+                z[l] = std::fmod(z[l], r);
+            }
+        }
+
+        // Unit cube, and location within it, for each lane - as per perlin()
+        std::array<int, Lanes> xi, yi, zi;
+        std::array<T, Lanes> xf, yf, zf;
+        for (unsigned int l = 0; l < Lanes; ++l) {
+            T const fx = detail::fast_floor(x[l]);
+            T const fy = detail::fast_floor(y[l]);
+            T const fz = detail::fast_floor(z[l]);
+            xi[l] = static_cast<int>(fx) & 255;
+            yi[l] = static_cast<int>(fy) & 255;
+            zi[l] = static_cast<int>(fz) & 255;
+            xf[l] = x[l] - fx;
+            yf[l] = y[l] - fy;
+            zf[l] = z[l] - fz;
+        }
+
+        // Hash the 8 cube corners for each lane
+        std::array<std::array<int, Lanes>, 8> h;
+        auto const & p {detail::PERMUTATION};
+        for (unsigned int l = 0; l < Lanes; ++l) {
+            int const xj = inc(xi[l]);
+            int const yj = inc(yi[l]);
+            int const zj = inc(zi[l]);
+            int const a  = p[xi[l]];
+            int const b  = p[xj];
+            int const aa = p[a + yi[l]];
+            int const ab = p[a + yj];
+            int const ba = p[b + yi[l]];
+            int const bb = p[b + yj];
+            h[0][l] = p[aa + zi[l]];  // aaa
+            h[1][l] = p[ba + zi[l]];  // baa
+            h[2][l] = p[ab + zi[l]];  // aba
+            h[3][l] = p[bb + zi[l]];  // bba
+            h[4][l] = p[aa + zj];     // aab
+            h[5][l] = p[ba + zj];     // bab
+            h[6][l] = p[ab + zj];     // abb
+            h[7][l] = p[bb + zj];     // bbb
+        }
+
+        using detail::grad_branchless;
+        using detail::fade;
+        using detail::lerp;
+        for (unsigned int l = 0; l < Lanes; ++l) {
+            T const u {fade(xf[l])};
+            T const v {fade(yf[l])};
+            T const w {fade(zf[l])};
+            T const x0 {xf[l]}, x1 {xf[l] - 1};
+            T const y0 {yf[l]}, y1 {yf[l] - 1};
+            T const z0 {zf[l]}, z1 {zf[l] - 1};
+
+            T const a1 = lerp(grad_branchless(h[0][l], x0, y0, z0), grad_branchless(h[1][l], x1, y0, z0), u);
+            T const a2 = lerp(grad_branchless(h[2][l], x0, y1, z0), grad_branchless(h[3][l], x1, y1, z0), u);
+            T const b1 = lerp(grad_branchless(h[4][l], x0, y0, z1), grad_branchless(h[5][l], x1, y0, z1), u);
+            T const b2 = lerp(grad_branchless(h[6][l], x0, y1, z1), grad_branchless(h[7][l], x1, y1, z1), u);
+
+            out[l] = (lerp(lerp(a1, a2, v), lerp(b1, b2, v), w) + T(1)) / T(2);
+        }
+    }
+
+    template <unsigned int Lanes, typename T>
+    void octave_perlin_block_(T const * xs, T const * ys, T const * zs, T * out,
+                              int octaves, T persistence) const {
+        std::array<T, Lanes> total {};
+        std::array<T, Lanes> x, y, z, noise;
+        T frequency = 1;
+        T amplitude = 1;
+        T max_value = 0;
+
+        for (int i = 0; i < octaves; ++i) {
+            for (unsigned int l = 0; l < Lanes; ++l) {
+                x[l] = xs[l] * frequency;
+                y[l] = ys[l] * frequency;
+                z[l] = zs[l] * frequency;
+            }
+            perlin_block_<Lanes>(x.data(), y.data(), z.data(), noise.data());
+            for (unsigned int l = 0; l < Lanes; ++l) {
+                total[l] += noise[l] * amplitude;
+            }
+            max_value += amplitude;
+            amplitude *= persistence;
+            frequency *= 2;
+        }
+
+        for (unsigned int l = 0; l < Lanes; ++l) {
+            out[l] = total[l] / max_value;
+        }
+    }
+
     inline int inc(int num) const {
         ++num;
         if (repeat_ > 0) {
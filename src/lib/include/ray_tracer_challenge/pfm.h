@@ -0,0 +1,144 @@
+// PFM (Portable Float Map) image input and output
+//
+// Stores the raw, unclamped canvas values as 32-bit floats, so exposure, tone
+// mapping and other post-processing can be repeated without re-rendering.
+//
+// Format: https://www.pauldebevec.com/Research/HDR/PFM/
+
+#ifndef RTC_LIB_PFM_H
+#define RTC_LIB_PFM_H
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "canvas.h"
+#include "color.h"
+#include "pixel_view.h"
+#include "ppm.h"
+
+namespace rtc {
+
+namespace detail {
+
+// PFM header for a little-endian colour image
+inline std::string pfm_header(unsigned int width, unsigned int height) {
+    return "PF\n" + std::to_string(width) + ' ' + std::to_string(height) + "\n-1.0\n";
+}
+
+inline char * store_u32_le(char * out, std::uint32_t value) {
+    if constexpr (std::endian::native == std::endian::big) {
+        value = __builtin_bswap32(value);
+    }
+    std::memcpy(out, &value, sizeof(value));
+    return out + sizeof(value);
+}
+
+inline char * store_float_le(char * out, float value) {
+    return store_u32_le(out, std::bit_cast<std::uint32_t>(value));
+}
+
+// The complete PFM file, ready for a single write.  Rows are stored bottom to top.
+template <typename Canvas>
+std::vector<char> pfm_from_canvas(Canvas const & canvas) {
+    auto const header = pfm_header(canvas.width(), canvas.height());
+    std::vector<char> pfm(header.size() + static_cast<std::size_t>(canvas.width()) * canvas.height() * 3 * sizeof(float));
+    auto * out = std::copy(header.begin(), header.end(), pfm.data());
+
+    RowReader rows {canvas};
+    for (auto row = canvas.height(); row > 0; --row) {
+        for (auto const & p : rows(row - 1)) {
+            out = store_float_le(out, static_cast<float>(p.red()));
+            out = store_float_le(out, static_cast<float>(p.green()));
+            out = store_float_le(out, static_cast<float>(p.blue()));
+        }
+    }
+    return pfm;
+}
+
+// A greyscale ("Pf") PFM file of width x height values, given top row first
+inline std::vector<char> pfm_from_values(unsigned int width, unsigned int height, std::span<float const> values) {
+    auto const header = "Pf\n" + std::to_string(width) + ' ' + std::to_string(height) + "\n-1.0\n";
+    std::vector<char> pfm(header.size() + static_cast<std::size_t>(width) * height * sizeof(float));
+    auto * out = std::copy(header.begin(), header.end(), pfm.data());
+    for (auto row = height; row > 0; --row) {
+        for (auto const v : values.subspan(static_cast<std::size_t>(row - 1) * width, width)) {
+            out = store_float_le(out, v);
+        }
+    }
+    return pfm;
+}
+
+} // namespace detail
+
+// Write width x height single-channel values (top row first, at least
+// width * height of them) to a stream as a greyscale PFM
+inline std::ostream & write_pfm(std::ostream & os, unsigned int width, unsigned int height,
+                                std::span<float const> values) {
+    auto const pfm = detail::pfm_from_values(width, height, values);
+    return os.write(pfm.data(), static_cast<std::streamsize>(pfm.size()));
+}
+
+// Write a canvas to a stream as PFM
+template <typename Canvas>
+std::ostream & write_pfm(std::ostream & os, Canvas const & canvas) {
+    auto const pfm = detail::pfm_from_canvas(canvas);
+    return os.write(pfm.data(), static_cast<std::streamsize>(pfm.size()));
+}
+
+// Write a canvas to a file descriptor as PFM.  Returns false if the write failed.
+template <typename Canvas>
+bool write_pfm(int fd, Canvas const & canvas) {
+    auto const pfm = detail::pfm_from_canvas(canvas);
+    return detail::FdSink{fd}.write(pfm.data(), pfm.size());
+}
+
+// Read a colour ("PF") or greyscale ("Pf") PFM image.  Returns std::nullopt if the
+// stream does not contain a valid PFM image.
+inline std::optional<Canvas<Color>> read_pfm(std::istream & is) {
+    std::string magic;
+    unsigned int width {};
+    unsigned int height {};
+    double scale {};
+    if (!(is >> magic >> width >> height >> scale) || (magic != "PF" && magic != "Pf") || scale == 0.0) {
+        return std::nullopt;
+    }
+    is.get();  // single whitespace character before the data
+
+    auto const channels = magic == "PF" ? 3U : 1U;
+    auto const big_endian = scale > 0.0;
+
+    std::vector<std::uint32_t> data(static_cast<std::size_t>(width) * height * channels);
+    if (!is.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size() * 4))) {
+        return std::nullopt;
+    }
+
+    auto const swap = big_endian != (std::endian::native == std::endian::big);
+    auto value = [&](std::size_t i) {
+        return static_cast<fp_t>(std::bit_cast<float>(swap ? __builtin_bswap32(data[i]) : data[i]));
+    };
+
+    Canvas<Color> image {width, height};
+    for (auto y = 0U; y < height; ++y) {
+        auto const row = static_cast<std::size_t>(height - 1 - y) * width;
+        for (auto x = 0U; x < width; ++x) {
+            auto const i = (row + x) * channels;
+            auto const c = channels == 3 ? Color {value(i), value(i + 1), value(i + 2)}
+                                         : Color {value(i), value(i), value(i)};
+            image.write_pixel(x, y, c);
+        }
+    }
+    return image;
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_PFM_H
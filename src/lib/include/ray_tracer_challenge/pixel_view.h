@@ -0,0 +1,94 @@
+// Unchecked 2D pixel views
+//
+// A PixelView is a non-owning window onto pixels laid out as rows of a fixed
+// stride, in the manner of std::mdspan with a strided layout.  Access does no
+// bounds checking; it is meant for the renderer and encoders, which already
+// know their loops stay inside the canvas.  Canvas::pixel_at and
+// Canvas::write_pixel remain the checked interface.
+
+#ifndef RTC_LIB_PIXEL_VIEW_H
+#define RTC_LIB_PIXEL_VIEW_H
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace rtc {
+
+template <typename PixelType>
+class PixelView {
+public:
+    using pixel_t = PixelType;
+
+    PixelView() = default;
+
+    // `stride` is the distance in pixels from one row to the next, and may be
+    // negative for images stored bottom to top
+    PixelView(PixelType * origin, unsigned int width, unsigned int height, std::ptrdiff_t stride) :
+        origin_{origin}, width_{width}, height_{height}, stride_{stride} {}
+
+    // A view of mutable pixels converts to a view of const pixels
+    template <typename Other>
+    requires std::is_same_v<PixelType, Other const>
+    PixelView(PixelView<Other> const & other) :
+        PixelView(other.data(), other.width(), other.height(), other.stride()) {}
+
+    unsigned int width() const { return width_; }
+    unsigned int height() const { return height_; }
+    std::ptrdiff_t stride() const { return stride_; }
+    PixelType * data() const { return origin_; }
+
+    PixelType & operator()(unsigned int x, unsigned int y) const {
+        return origin_[static_cast<std::ptrdiff_t>(y) * stride_ + x];
+    }
+
+    std::span<PixelType> row(unsigned int y) const {
+        return {origin_ + static_cast<std::ptrdiff_t>(y) * stride_, width_};
+    }
+
+    PixelView subview(unsigned int x, unsigned int y, unsigned int width, unsigned int height) const {
+        return {&(*this)(x, y), width, height, stride_};
+    }
+
+private:
+    PixelType * origin_ {};
+    unsigned int width_ {};
+    unsigned int height_ {};
+    std::ptrdiff_t stride_ {};
+};
+
+namespace detail {
+
+// Reads a canvas one row at a time, as a span.  Rows come straight from the
+// canvas when its storage keeps them contiguous; otherwise (as with tiled
+// storage) each row is gathered into a buffer first.
+template <typename Canvas>
+class RowReader {
+public:
+    using pixel_t = typename Canvas::pixel_t;
+
+    explicit RowReader(Canvas const & canvas) : canvas_{canvas} {}
+
+    std::span<pixel_t const> operator()(unsigned int y) {
+        if constexpr (requires { canvas_.row(y); }) {
+            return canvas_.row(y);
+        } else {
+            buffer_.resize(canvas_.width());
+            for (auto x = 0U; x < canvas_.width(); ++x) {
+                buffer_[x] = canvas_.storage().at(x, y);
+            }
+            return buffer_;
+        }
+    }
+
+private:
+    Canvas const & canvas_;
+    std::vector<pixel_t> buffer_ {};
+};
+
+} // namespace detail
+
+} // namespace rtc
+
+#endif // RTC_LIB_PIXEL_VIEW_H
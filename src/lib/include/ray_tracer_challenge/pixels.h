@@ -0,0 +1,292 @@
+// Compact pixel types
+//
+// Canvas<Color> stores four doubles and a vtable pointer (40 bytes) per pixel.
+// These plain structs hold only the colour channels, so a canvas of them can
+// be stored densely, memory-mapped, or written out without conversion:
+//
+//   Rgb32f  12 bytes  linear float RGB, lossless for rendered values
+//   Rgb16f   6 bytes  linear half-float RGB, ~3 significant digits, range 65504
+//   Rgbe     4 bytes  shared-exponent RGB (Ward), 8-bit mantissas, non-negative only
+//   Srgb8    3 bytes  8-bit sRGB-encoded, clamped to [0, 1]
+//   Rgb8     3 bytes  8-bit display codes, output as they are
+//
+// Every type converts to and from Color, and red(), green() and blue() return
+// linear values (Rgb8 excepted), so the image writers accept any of them.
+
+#ifndef RTC_LIB_PIXELS_H
+#define RTC_LIB_PIXELS_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "color.h"
+
+namespace rtc {
+
+namespace detail {
+
+// IEEE 754 binary16 conversions, rounding to nearest even.  Written with
+// selects rather than branches so that loops over them vectorize.
+inline std::uint16_t float_to_half(float f) {
+    auto const x = std::bit_cast<std::uint32_t>(f);
+    auto const sign = (x >> 16) & 0x8000U;
+    auto const abs = x & 0x7fffffffU;
+
+    // Subnormal results: let the FPU round by adding 0.5, whose ulp is 2^-24
+    auto const subnormal = std::bit_cast<std::uint32_t>(std::bit_cast<float>(abs) + 0.5f) - 0x3f000000U;
+    // Normal results: rebias the exponent, round the dropped 13 bits to even
+    auto const normal = (abs + 0xc8000fffU + ((abs >> 13) & 1U)) >> 13;
+    auto const nan = 0x7e00U;
+    auto const inf = 0x7c00U;
+
+    auto const magnitude = abs > 0x7f800000U ? nan
+                         : abs >= 0x477ff000U ? inf
+                         : abs < 0x38800000U ? subnormal
+                         : normal;
+    return static_cast<std::uint16_t>(sign | magnitude);
+}
+
+inline float half_to_float(std::uint16_t h) {
+    auto const sign = static_cast<std::uint32_t>(h & 0x8000U) << 16;
+    auto const exponent = (h >> 10) & 0x1fU;
+    auto const mantissa = static_cast<std::uint32_t>(h & 0x3ffU);
+
+    auto const subnormal = std::bit_cast<std::uint32_t>(static_cast<float>(mantissa) * 0x1p-24f);
+    auto const normal = ((exponent + 112U) << 23) | (mantissa << 13);
+    auto const special = 0x7f800000U | (mantissa << 13);
+
+    auto const magnitude = exponent == 0 ? subnormal : exponent == 0x1f ? special : normal;
+    return std::bit_cast<float>(sign | magnitude);
+}
+
+inline double srgb_decode(double v) {
+    return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+}
+
+inline double srgb_encode(double v) {
+    return v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+}
+
+// Linear value of each 8-bit sRGB code
+inline const auto SRGB8_TO_LINEAR = [] {
+    std::array<float, 256> table {};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        table[i] = static_cast<float>(srgb_decode(static_cast<double>(i) / 255.0));
+    }
+    return table;
+}();
+
+// Linear value half way between consecutive sRGB codes: a linear value encodes
+// to the number of thresholds at or below it
+inline const auto SRGB8_THRESHOLDS = [] {
+    std::array<float, 256> table {};
+    for (std::size_t i = 0; i < 255; ++i) {
+        table[i] = static_cast<float>(srgb_decode((static_cast<double>(i) + 0.5) / 255.0));
+    }
+    table[255] = 2.0f;  // unreachable
+    return table;
+}();
+
+// The thresholds are never closer than 1 / (255 * 12.92), so with bins of
+// 1/4096 each bin holds at most one of them.  This table gives the code at
+// the start of each bin.
+constexpr std::size_t SRGB8_ENCODE_BINS {4096};
+
+inline const auto SRGB8_ENCODE_TABLE = [] {
+    std::array<std::uint8_t, SRGB8_ENCODE_BINS> table {};
+    std::size_t code {0};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        auto const start = static_cast<float>(i) / SRGB8_ENCODE_BINS;
+        while (SRGB8_THRESHOLDS[code] <= start) {
+            ++code;
+        }
+        table[i] = static_cast<std::uint8_t>(code);
+    }
+    return table;
+}();
+
+// Exact sRGB encoding of a linear value, clamped to [0, 1] (NaN encodes as 0):
+// look up the bin, then step past the one threshold it may contain
+inline std::uint8_t linear_to_srgb8(float v) {
+    v = v >= 0.0f ? std::min(v, 1.0f) : 0.0f;
+    auto const bin = std::min(static_cast<std::size_t>(v * SRGB8_ENCODE_BINS), SRGB8_ENCODE_BINS - 1);
+    auto const code = SRGB8_ENCODE_TABLE[bin];
+    return static_cast<std::uint8_t>(code + (v >= SRGB8_THRESHOLDS[code] ? 1 : 0));
+}
+
+} // namespace detail
+
+// Linear RGB, one 32-bit float per channel
+struct Rgb32f {
+    float r {};
+    float g {};
+    float b {};
+
+    Rgb32f() = default;
+    Rgb32f(float red, float green, float blue) : r{red}, g{green}, b{blue} {}
+    explicit Rgb32f(Color const & c) :
+        r{static_cast<float>(c.red())},
+        g{static_cast<float>(c.green())},
+        b{static_cast<float>(c.blue())} {}
+
+    fp_t red() const { return r; }
+    fp_t green() const { return g; }
+    fp_t blue() const { return b; }
+
+    Color to_color() const { return Color {r, g, b}; }
+
+    friend bool operator==(Rgb32f const &, Rgb32f const &) = default;
+};
+
+// Linear RGB, one IEEE 754 half-precision float per channel
+struct Rgb16f {
+    std::uint16_t r {};
+    std::uint16_t g {};
+    std::uint16_t b {};
+
+    Rgb16f() = default;
+    explicit Rgb16f(Color const & c) :
+        r{detail::float_to_half(static_cast<float>(c.red()))},
+        g{detail::float_to_half(static_cast<float>(c.green()))},
+        b{detail::float_to_half(static_cast<float>(c.blue()))} {}
+
+    fp_t red() const { return detail::half_to_float(r); }
+    fp_t green() const { return detail::half_to_float(g); }
+    fp_t blue() const { return detail::half_to_float(b); }
+
+    Color to_color() const { return Color {red(), green(), blue()}; }
+
+    friend bool operator==(Rgb16f const &, Rgb16f const &) = default;
+};
+
+// Shared-exponent RGB as used by Radiance .hdr files: three 8-bit mantissas
+// scaled by 2^(e - 136).  Negative channels are stored as zero.  Mantissas are
+// rounded rather than truncated, so zero channels decode to exactly zero.
+struct Rgbe {
+    std::uint8_t r {};
+    std::uint8_t g {};
+    std::uint8_t b {};
+    std::uint8_t e {};
+
+    Rgbe() = default;
+    explicit Rgbe(Color const & c) {
+        auto const red = std::max(static_cast<float>(c.red()), 0.0f);
+        auto const green = std::max(static_cast<float>(c.green()), 0.0f);
+        auto const blue = std::max(static_cast<float>(c.blue()), 0.0f);
+        auto const m = std::min(std::max({red, green, blue}), 0x1.fffffep126f);
+        if (m < 1e-32f) {
+            return;
+        }
+        // m = f * 2^exponent with f in [0.5, 1), as std::frexp would give
+        auto const exponent = static_cast<int>((std::bit_cast<std::uint32_t>(m) >> 23) & 0xff) - 126;
+        auto const scale = std::bit_cast<float>(static_cast<std::uint32_t>(127 + 8 - exponent) << 23);
+        r = mantissa_(red * scale);
+        g = mantissa_(green * scale);
+        b = mantissa_(blue * scale);
+        e = static_cast<std::uint8_t>(exponent + 128);
+    }
+
+    fp_t red() const { return r * scale_(); }
+    fp_t green() const { return g * scale_(); }
+    fp_t blue() const { return b * scale_(); }
+
+    Color to_color() const { return Color {red(), green(), blue()}; }
+
+    friend bool operator==(Rgbe const &, Rgbe const &) = default;
+
+private:
+    static std::uint8_t mantissa_(float v) {
+        return static_cast<std::uint8_t>(std::min(std::rint(v), 255.0f));
+    }
+
+    // 2^(e - 136), or zero for e == 0 (and for exponents too small for a normal float)
+    float scale_() const {
+        return e <= 9 ? 0.0f : std::bit_cast<float>(static_cast<std::uint32_t>(e - 9) << 23);
+    }
+};
+
+// 8-bit sRGB-encoded RGB, for display output
+struct Srgb8 {
+    std::uint8_t r {};
+    std::uint8_t g {};
+    std::uint8_t b {};
+
+    Srgb8() = default;
+    Srgb8(std::uint8_t red, std::uint8_t green, std::uint8_t blue) : r{red}, g{green}, b{blue} {}
+    explicit Srgb8(Color const & c) :
+        r{detail::linear_to_srgb8(static_cast<float>(c.red()))},
+        g{detail::linear_to_srgb8(static_cast<float>(c.green()))},
+        b{detail::linear_to_srgb8(static_cast<float>(c.blue()))} {}
+
+    fp_t red() const { return detail::SRGB8_TO_LINEAR[r]; }
+    fp_t green() const { return detail::SRGB8_TO_LINEAR[g]; }
+    fp_t blue() const { return detail::SRGB8_TO_LINEAR[b]; }
+
+    Color to_color() const { return Color {red(), green(), blue()}; }
+
+    friend bool operator==(Srgb8 const &, Srgb8 const &) = default;
+};
+
+// 8-bit display-referred RGB: codes already encoded for display (for example by
+// post_process()), which the image writers output unchanged.  red(), green() and
+// blue() return code / 255, with no transfer function applied.
+struct Rgb8 {
+    std::uint8_t r {};
+    std::uint8_t g {};
+    std::uint8_t b {};
+
+    Rgb8() = default;
+    Rgb8(std::uint8_t red, std::uint8_t green, std::uint8_t blue) : r{red}, g{green}, b{blue} {}
+    explicit Rgb8(Color const & c) :
+        r{detail::quantize_channel(c.red())},
+        g{detail::quantize_channel(c.green())},
+        b{detail::quantize_channel(c.blue())} {}
+
+    fp_t red() const { return r / 255.0; }
+    fp_t green() const { return g / 255.0; }
+    fp_t blue() const { return b / 255.0; }
+
+    Color to_color() const { return Color {red(), green(), blue()}; }
+
+    friend bool operator==(Rgb8 const &, Rgb8 const &) = default;
+};
+
+static_assert(sizeof(Rgb32f) == 12 && std::is_trivially_copyable_v<Rgb32f>);
+static_assert(sizeof(Rgb16f) == 6 && std::is_trivially_copyable_v<Rgb16f>);
+static_assert(sizeof(Rgbe) == 4 && std::is_trivially_copyable_v<Rgbe>);
+static_assert(sizeof(Srgb8) == 3 && std::is_trivially_copyable_v<Srgb8>);
+static_assert(sizeof(Rgb8) == 3 && std::is_trivially_copyable_v<Rgb8>);
+
+// Convert between pixel types, going through Color where neither side is one
+template <typename PixelType, typename Source>
+PixelType to_pixel(Source const & p) {
+    if constexpr (std::is_same_v<PixelType, Source>) {
+        return p;
+    } else if constexpr (std::is_same_v<Source, Color>) {
+        return PixelType {p};
+    } else if constexpr (std::is_same_v<PixelType, Color>) {
+        return p.to_color();
+    } else {
+        return PixelType {p.to_color()};
+    }
+}
+
+// Convert a run of pixels.  The per-pixel conversions are branch-free, so for
+// the float-based types the compiler vectorizes this loop.
+template <typename PixelType, typename Source>
+void convert_pixels(std::span<Source const> src, std::span<PixelType> dst) {
+    auto const n = std::min(src.size(), dst.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] = to_pixel<PixelType>(src[i]);
+    }
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_PIXELS_H
@@ -5,6 +5,7 @@
 #include "tuples.h"
 #include "intersections.h"
 #include "shapes.h"
+#include "stats.h"
 
 namespace rtc {
 
@@ -46,6 +47,8 @@ inline Vector local_normal_at(Plane const & plane, Point const & local_point) {
 
 inline Intersections local_intersect(Plane const & plane,
                                      Ray const & local_ray) {
+    count_stat<&RenderStats::plane_tests>();
+
     // The plane is at the origin, extending infinitely in both X and Z directions.
     //
     // 4 cases:
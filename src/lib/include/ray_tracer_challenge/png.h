@@ -0,0 +1,112 @@
+// PNG image output
+//
+// Writes 8-bit RGB PNG files directly from a canvas.  Rows are grouped into
+// bands; each band is filtered and deflated independently (on a thread pool,
+// if one is given) and written out in order as soon as it and all earlier
+// bands are done.
+//
+// PNG specification: https://www.w3.org/TR/png/
+
+#ifndef RTC_LIB_PNG_H
+#define RTC_LIB_PNG_H
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <ostream>
+#include <vector>
+
+#include "color.h"
+#include "pixel_view.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+namespace rtc {
+
+class PngWriter {
+public:
+    static constexpr unsigned int DEFAULT_BAND_ROWS {32};
+
+    // Rows are compressed on `pool` if given, otherwise on the calling thread.
+    // `level` is the zlib compression level, 0-9.
+    PngWriter(std::ostream & os, unsigned int width, unsigned int height,
+              ThreadPool * pool = nullptr, int level = 6,
+              unsigned int band_rows = DEFAULT_BAND_ROWS);
+
+    // Waits for outstanding bands, but does not complete the file
+    ~PngWriter();
+
+    PngWriter(PngWriter const &) = delete;
+    PngWriter & operator=(PngWriter const &) = delete;
+
+    // Append the next `num_rows` rows, as 8-bit RGB triples (width * 3 bytes per row).
+    // Completed bands are written to the stream as they become available.
+    void write_rows(std::uint8_t const * rgb, unsigned int num_rows);
+
+    // Write any remaining bands and the end of the file.  Returns false if the
+    // stream failed, a band could not be compressed, or not all rows were
+    // written (the file is then left truncated).
+    bool finish();
+
+private:
+    struct Band {
+        std::vector<std::uint8_t> compressed {};
+        std::uint32_t adler {};
+        std::size_t filtered_size {};
+        bool ok {true};             // false if zlib failed; `compressed` is then incomplete
+    };
+
+    static Band compress_band_(std::vector<std::uint8_t> rows,
+                               std::vector<std::uint8_t> previous_row,
+                               unsigned int width, int level, bool last);
+
+    void submit_band_();
+    void write_ready_bands_(bool wait);
+    void write_chunk_(char const * type, std::uint8_t const * data, std::size_t size);
+
+private:
+    std::ostream & os_;
+    unsigned int width_;
+    unsigned int height_;
+    ThreadPool * pool_;
+    int level_;
+    unsigned int band_rows_;
+
+    unsigned int rows_received_ {0};
+    std::vector<std::uint8_t> band_ {};          // raw rows of the band being collected
+    std::vector<std::uint8_t> previous_row_ {};  // last raw row of the previous band
+    std::deque<std::future<Band>> pending_ {};
+    std::uint32_t adler_ {1};
+    bool idat_started_ {false};
+    bool finished_ {false};
+    bool failed_ {false};
+};
+
+// Write a canvas to a stream as PNG, compressing bands in parallel on `pool`
+template <typename Canvas>
+bool write_png(std::ostream & os, Canvas const & canvas, ThreadPool * pool, int level = 6) {
+    TraceSpan const span {"write png", "encode"};
+    PngWriter writer {os, canvas.width(), canvas.height(), pool, level};
+    std::vector<std::uint8_t> row(canvas.width() * 3);
+    detail::RowReader rows {canvas};
+    for (auto y = 0U; y < canvas.height(); ++y) {
+        auto * out = row.data();
+        for (auto const & p : rows(y)) {
+            *out++ = detail::quantize_channel(p.red());
+            *out++ = detail::quantize_channel(p.green());
+            *out++ = detail::quantize_channel(p.blue());
+        }
+        writer.write_rows(row.data(), 1);
+    }
+    return writer.finish();
+}
+
+// Write a canvas to a stream as PNG, compressing on the calling thread
+template <typename Canvas>
+bool write_png(std::ostream & os, Canvas const & canvas, int level = 6) {
+    return write_png(os, canvas, nullptr, level);
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_PNG_H
@@ -0,0 +1,173 @@
+// Post-processing: exposure, tone mapping, sRGB encoding, dithering, quantizing
+//
+// Turns a canvas of linear radiance into 8-bit display codes, ready for any of
+// the image writers.  Rows are handled in bands on several threads.  Each row
+// is unpacked into a flat float buffer and every stage runs as a simple
+// branch-free loop over it, which the compiler vectorizes.
+
+#ifndef RTC_LIB_POST_PROCESS_H
+#define RTC_LIB_POST_PROCESS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "canvas.h"
+#include "pixel_view.h"
+#include "pixels.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+namespace rtc {
+
+enum class ToneMap {
+    clamp,      // clip to [0, 1]
+    reinhard,   // x / (1 + x)
+    aces,       // Narkowicz's fit to the ACES filmic curve
+    filmic,     // Hable's "Uncharted 2" curve, white point 11.2
+};
+
+struct PostProcessOptions {
+    fp_t exposure {0.0};            // in stops: pixels are scaled by 2^exposure
+    ToneMap tone_map {ToneMap::clamp};
+    bool srgb {true};               // apply the sRGB transfer function
+    bool dither {false};            // ordered dither before quantizing, to hide banding
+    unsigned int threads {0};       // 0: one per hardware thread
+    ThreadPool * pool {nullptr};    // if set, workers come from it rather than from a pool per call
+};
+
+namespace detail {
+
+constexpr unsigned int POST_PROCESS_BAND_ROWS {16};
+
+// The sRGB transfer function sampled at steps of 1/4096, for linear
+// interpolation.  The curve is linear near zero and smooth above, so the
+// interpolated value is within 0.005 of an 8-bit step of the exact one.
+constexpr std::size_t SRGB_CURVE_STEPS {4096};
+
+inline const auto SRGB_CURVE = [] {
+    std::array<float, SRGB_CURVE_STEPS + 1> table {};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        table[i] = static_cast<float>(srgb_encode(static_cast<double>(i) / SRGB_CURVE_STEPS));
+    }
+    return table;
+}();
+
+// 8x8 Bayer matrix: each pixel in a block gets a different threshold
+constexpr std::array<std::uint8_t, 64> BAYER_8X8 {
+     0, 32,  8, 40,  2, 34, 10, 42,
+    48, 16, 56, 24, 50, 18, 58, 26,
+    12, 44,  4, 36, 14, 46,  6, 38,
+    60, 28, 52, 20, 62, 30, 54, 22,
+     3, 35, 11, 43,  1, 33,  9, 41,
+    51, 19, 59, 27, 49, 17, 57, 25,
+    15, 47,  7, 39, 13, 45,  5, 37,
+    63, 31, 55, 23, 61, 29, 53, 21,
+};
+
+// Negative values and NaN become zero
+inline float non_negative(float v) {
+    return v > 0.0f ? v : 0.0f;
+}
+
+inline float hable_partial(float x) {
+    constexpr float a {0.15f}, b {0.50f}, c {0.10f}, d {0.20f}, e {0.02f}, f {0.30f};
+    return (x * (a * x + c * b) + d * e) / (x * (a * x + b) + d * f) - e / f;
+}
+
+// Map values to [0, 1], in place
+inline void apply_tone_map(std::span<float> values, ToneMap op) {
+    switch (op) {
+    case ToneMap::clamp:
+        for (auto & v : values) {
+            v = std::min(non_negative(v), 1.0f);
+        }
+        break;
+    case ToneMap::reinhard:
+        for (auto & v : values) {
+            auto const x = non_negative(v);
+            v = x / (1.0f + x);
+        }
+        break;
+    case ToneMap::aces:
+        for (auto & v : values) {
+            auto const x = non_negative(v);
+            v = std::min((x * (2.51f * x + 0.03f)) / (x * (2.43f * x + 0.59f) + 0.14f), 1.0f);
+        }
+        break;
+    case ToneMap::filmic: {
+        auto const white_scale = 1.0f / hable_partial(11.2f);
+        for (auto & v : values) {
+            // Clamp the input too: the curve turns back down far past the white point
+            auto const x = std::min(non_negative(v), 11.2f);
+            v = std::min(hable_partial(2.0f * x) * white_scale, 1.0f);
+        }
+        break;
+    }
+    }
+}
+
+// sRGB-encode values in [0, 1], in place
+inline void apply_srgb(std::span<float> values) {
+    for (auto & v : values) {
+        auto const t = v * SRGB_CURVE_STEPS;
+        auto const i = std::min(static_cast<int>(t), static_cast<int>(SRGB_CURVE_STEPS) - 1);
+        auto const f = t - static_cast<float>(i);
+        v = SRGB_CURVE[i] + (SRGB_CURVE[i + 1] - SRGB_CURVE[i]) * f;
+    }
+}
+
+// Quantize one row of interleaved RGB values in [0, 1].  Without dithering
+// values round to the nearest code; with it, each pixel's threshold comes from
+// its place in the Bayer matrix, which preserves the average over a block.
+inline void quantize_row(std::span<float const> values, std::span<Rgb8> out, unsigned int y, bool dither) {
+    auto const * bayer_row = BAYER_8X8.data() + (y % 8) * 8;
+    for (std::size_t x = 0; x < out.size(); ++x) {
+        auto const offset = dither ? (bayer_row[x % 8] + 0.5f) / 64.0f : 0.5f;
+        auto const * v = values.data() + 3 * x;
+        out[x] = Rgb8 {static_cast<std::uint8_t>(std::min(v[0] * 255.0f + offset, 255.0f)),
+                       static_cast<std::uint8_t>(std::min(v[1] * 255.0f + offset, 255.0f)),
+                       static_cast<std::uint8_t>(std::min(v[2] * 255.0f + offset, 255.0f))};
+    }
+}
+
+} // namespace detail
+
+// Convert a canvas of linear colour to 8-bit display codes.  The result can be
+// passed straight to write_ppm(), write_png() and the other writers.
+template <typename Canvas>
+auto post_process(Canvas const & src, PostProcessOptions const & options = {}) {
+    TraceSpan const span {"post process", "post process"};
+    ::rtc::Canvas<Rgb8> dst {src.width(), src.height()};
+    auto const scale = static_cast<float>(std::exp2(options.exposure));
+    auto const bands = (src.height() + detail::POST_PROCESS_BAND_ROWS - 1) / detail::POST_PROCESS_BAND_ROWS;
+
+    parallel_for(bands, options.threads, [&](unsigned int band) {
+        TraceSpan const band_span {"band", "post process", band};
+        detail::RowReader rows {src};
+        std::vector<float> values(3 * static_cast<std::size_t>(src.width()));
+        auto const y_end = std::min((band + 1) * detail::POST_PROCESS_BAND_ROWS, src.height());
+        for (auto y = band * detail::POST_PROCESS_BAND_ROWS; y < y_end; ++y) {
+            auto * v = values.data();
+            for (auto const & p : rows(y)) {
+                *v++ = static_cast<float>(p.red()) * scale;
+                *v++ = static_cast<float>(p.green()) * scale;
+                *v++ = static_cast<float>(p.blue()) * scale;
+            }
+            detail::apply_tone_map(values, options.tone_map);
+            if (options.srgb) {
+                detail::apply_srgb(values);
+            }
+            detail::quantize_row(values, dst.row(y), y, options.dither);
+        }
+    }, options.pool);
+    return dst;
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_POST_PROCESS_H
@@ -0,0 +1,123 @@
+// Per-object profiling hooks
+//
+// With the RTC_ENABLE_PROFILING build option, the renderer times the work it
+// does for each shape: testing rays against it, shading hits on it (less any
+// shadow rays and pattern lookups, which are timed separately), and looking
+// up its pattern.  Times go to the ObjectCosts installed on the thread, if
+// any; see object_profile.h for rendering with them and reporting them.
+//
+// Without RTC_ENABLE_PROFILING every ObjectTimer compiles to nothing.
+
+#ifndef RTC_LIB_PROFILING_H
+#define RTC_LIB_PROFILING_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace rtc {
+
+#ifdef RTC_ENABLE_PROFILING
+constexpr bool PROFILING_ENABLED {true};
+#else
+constexpr bool PROFILING_ENABLED {false};
+#endif
+
+class Shape;
+
+enum class ObjectPhase {
+    intersection,   // ray-shape intersection tests
+    shading,        // normals, lighting and colour, not counting shadow rays or patterns
+    pattern,        // pattern lookups, including nested patterns and noise
+};
+
+constexpr std::size_t NUM_OBJECT_PHASES {3};
+
+struct ObjectCost {
+    std::array<std::uint64_t, NUM_OBJECT_PHASES> nanoseconds {};
+    std::array<std::uint64_t, NUM_OBJECT_PHASES> calls {};
+
+    std::uint64_t ns(ObjectPhase phase) const { return nanoseconds[static_cast<std::size_t>(phase)]; }
+    std::uint64_t count(ObjectPhase phase) const { return calls[static_cast<std::size_t>(phase)]; }
+
+    std::uint64_t total_ns() const {
+        return nanoseconds[0] + nanoseconds[1] + nanoseconds[2];
+    }
+
+    ObjectCost & operator+=(ObjectCost const & rhs) {
+        for (std::size_t i = 0; i < NUM_OBJECT_PHASES; ++i) {
+            nanoseconds[i] += rhs.nanoseconds[i];
+            calls[i] += rhs.calls[i];
+        }
+        return *this;
+    }
+};
+
+using ObjectCosts = std::unordered_map<Shape const *, ObjectCost>;
+
+namespace detail {
+
+// Where this thread's timers record, if anywhere
+inline thread_local ObjectCosts * thread_object_costs {nullptr};
+
+// Time spent in timers nested inside the innermost running one
+inline thread_local std::uint64_t * thread_nested_ns {nullptr};
+
+inline std::uint64_t profile_clock_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace detail
+
+// Times one phase of work on a shape, from construction to destruction.
+// Timers nest: an outer timer is only charged for its own time.
+class ObjectTimer {
+public:
+    ObjectTimer(Shape const & shape, ObjectPhase phase) {
+        if constexpr (PROFILING_ENABLED) {
+            if (detail::thread_object_costs) {
+                shape_ = &shape;
+                phase_ = phase;
+                outer_nested_ns_ = detail::thread_nested_ns;
+                detail::thread_nested_ns = &nested_ns_;
+                start_ns_ = detail::profile_clock_ns();
+            }
+        } else {
+            (void)shape;
+            (void)phase;
+        }
+    }
+
+    ~ObjectTimer() {
+        if constexpr (PROFILING_ENABLED) {
+            if (shape_) {
+                auto const elapsed = detail::profile_clock_ns() - start_ns_;
+                detail::thread_nested_ns = outer_nested_ns_;
+                if (outer_nested_ns_) {
+                    *outer_nested_ns_ += elapsed;
+                }
+                auto & cost = (*detail::thread_object_costs)[shape_];
+                auto const i = static_cast<std::size_t>(phase_);
+                cost.nanoseconds[i] += elapsed - nested_ns_;
+                ++cost.calls[i];
+            }
+        }
+    }
+
+    ObjectTimer(ObjectTimer const &) = delete;
+    ObjectTimer & operator=(ObjectTimer const &) = delete;
+
+private:
+    Shape const * shape_ {};
+    ObjectPhase phase_ {};
+    std::uint64_t start_ns_ {};
+    std::uint64_t nested_ns_ {};
+    std::uint64_t * outer_nested_ns_ {};
+};
+
+} // namespace rtc
+
+#endif // RTC_LIB_PROFILING_H
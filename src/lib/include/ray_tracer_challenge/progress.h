@@ -0,0 +1,175 @@
+// Render progress reporting
+//
+// A tiled render given a progress callback (see RenderOptions) starts a
+// reporter thread, which calls it at a fixed interval with the tiles done so
+// far, the current camera rays per second, how busy the render threads are
+// and an estimate of the time left, and once more when the render is done.
+// The render threads only add to a few atomic counters as they finish each
+// tile; all the arithmetic and the callback itself run on the reporter.
+
+#ifndef RTC_LIB_PROGRESS_H
+#define RTC_LIB_PROGRESS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace rtc {
+
+struct RenderProgress {
+    unsigned int tiles_done {};
+    unsigned int tiles_total {};
+    double elapsed_seconds {};
+    double rays_per_second {};              // camera rays, over the last interval (the whole render, once done)
+    double utilization {};                  // share of the render threads' time spent on tiles, likewise
+    std::optional<double> eta_seconds {};   // at the average rate so far; unknown until a tile is done
+
+    bool done() const { return tiles_done == tiles_total; }
+};
+
+// Called on the reporter thread; must not throw
+using ProgressCallback = std::function<void(RenderProgress const &)>;
+
+namespace detail {
+
+class ProgressTracker {
+public:
+    using clock = std::chrono::steady_clock;
+
+    ProgressTracker(ProgressCallback callback, std::chrono::milliseconds interval,
+                    unsigned int tiles, std::uint64_t pixels, unsigned int threads) :
+        callback_{std::move(callback)}, interval_{std::max(interval, std::chrono::milliseconds {1})},
+        tiles_{tiles}, pixels_{pixels}, threads_{std::max(threads, 1U)}, start_{clock::now()},
+        reporter_{[this] { run_(); }} {}
+
+    // Stops the reporter, then reports the finished render
+    ~ProgressTracker() {
+        {
+            std::lock_guard const lock {mutex_};
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        reporter_.join();
+        report_(true);
+    }
+
+    ProgressTracker(ProgressTracker const &) = delete;
+    ProgressTracker & operator=(ProgressTracker const &) = delete;
+
+    // Called by the render threads as each tile is finished
+    void tile_done(std::uint64_t pixels, clock::duration busy) {
+        pixels_done_.fetch_add(pixels, std::memory_order_relaxed);
+        busy_ns_.fetch_add(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count()), std::memory_order_relaxed);
+        tiles_done_.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    void run_() {
+        std::unique_lock lock {mutex_};
+        while (!cv_.wait_for(lock, interval_, [this] { return stopping_; })) {
+            lock.unlock();
+            report_(false);
+            lock.lock();
+        }
+    }
+
+    void report_(bool final) {
+        auto const now = clock::now();
+        auto const tiles_done = tiles_done_.load(std::memory_order_acquire);
+        auto const pixels_done = pixels_done_.load(std::memory_order_relaxed);
+        auto const busy_ns = busy_ns_.load(std::memory_order_relaxed);
+
+        // Rates over the last interval, or the whole render once it is done
+        auto const since = final ? start_ : last_time_;
+        auto const seconds = std::chrono::duration<double>(now - since).count();
+        auto const pixels = pixels_done - (final ? 0 : last_pixels_);
+        auto const busy = static_cast<double>(busy_ns - (final ? 0 : last_busy_ns_)) * 1e-9;
+
+        RenderProgress progress {};
+        progress.tiles_done = tiles_done;
+        progress.tiles_total = tiles_;
+        progress.elapsed_seconds = std::chrono::duration<double>(now - start_).count();
+        if (seconds > 0.0) {
+            progress.rays_per_second = static_cast<double>(pixels) / seconds;
+            progress.utilization = std::min(busy / (seconds * threads_), 1.0);
+        }
+        if (pixels_done > 0) {
+            progress.eta_seconds = progress.elapsed_seconds * static_cast<double>(pixels_ - pixels_done) /
+                                   static_cast<double>(pixels_done);
+        }
+
+        last_time_ = now;
+        last_pixels_ = pixels_done;
+        last_busy_ns_ = busy_ns;
+        callback_(progress);
+    }
+
+    ProgressCallback callback_;
+    std::chrono::milliseconds interval_;
+    unsigned int tiles_;
+    std::uint64_t pixels_;
+    unsigned int threads_;
+    clock::time_point start_;
+
+    std::atomic<unsigned int> tiles_done_ {0};
+    std::atomic<std::uint64_t> pixels_done_ {0};
+    std::atomic<std::uint64_t> busy_ns_ {0};
+
+    // Only used by the reporter (and the destructor, once it has stopped)
+    clock::time_point last_time_ {start_};
+    std::uint64_t last_pixels_ {0};
+    std::uint64_t last_busy_ns_ {0};
+
+    std::mutex mutex_ {};
+    std::condition_variable cv_ {};
+    bool stopping_ {false};
+    std::thread reporter_;      // last, so everything it uses is ready before it starts
+};
+
+inline std::string format_duration(double seconds) {
+    auto const s = static_cast<long>(seconds + 0.5);
+    std::ostringstream os;
+    if (s >= 3600) {
+        os << s / 3600 << ":" << std::setw(2) << std::setfill('0') << s / 60 % 60;
+    } else {
+        os << s / 60;
+    }
+    os << ":" << std::setw(2) << std::setfill('0') << s % 60;
+    return os.str();
+}
+
+} // namespace detail
+
+// A progress callback that keeps one status line up to date on `os`, e.g.
+//    42%  107/256 tiles  1.25 Mrays/s  threads 97% busy  ETA 0:12
+// and ends it with a newline when the render is done.  `os` must outlive the render.
+inline ProgressCallback print_progress(std::ostream & os) {
+    return [&os](RenderProgress const & p) {
+        auto const percent = p.tiles_total > 0 ? 100 * p.tiles_done / p.tiles_total : 100;
+        std::ostringstream line;
+        line << "\r" << std::setw(4) << percent << "%  " << p.tiles_done << "/" << p.tiles_total << " tiles  "
+             << std::fixed << std::setprecision(2) << p.rays_per_second / 1e6 << " Mrays/s  threads "
+             << std::setprecision(0) << 100.0 * p.utilization << "% busy  ";
+        if (p.done()) {
+            line << "took " << detail::format_duration(p.elapsed_seconds) << "\n";
+        } else if (p.eta_seconds) {
+            line << "ETA " << detail::format_duration(*p.eta_seconds) << "  ";
+        }
+        os << line.str() << std::flush;
+    };
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_PROGRESS_H
@@ -0,0 +1,174 @@
+// Parallel tiled rendering
+//
+// The image is divided into square tiles, which worker threads take in turn
+// (see parallel_for) until none are left.  Rendering a tile at a time keeps
+// each thread's writes close together, which pays off most with a canvas using
+// TiledStorage of the same tile size.
+
+#ifndef RTC_LIB_RENDER_H
+#define RTC_LIB_RENDER_H
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "camera.h"
+#include "canvas.h"
+#include "pixel_view.h"
+#include "pixels.h"
+#include "progress.h"
+#include "stats.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include "world.h"
+
+namespace rtc {
+
+struct RenderOptions {
+    unsigned int threads {0};      // 0: one per hardware thread
+    unsigned int tile_size {32};
+    ProgressCallback progress {};  // if set, called every progress_interval and when done (see progress.h)
+    std::chrono::milliseconds progress_interval {500};
+    ThreadPool * pool {nullptr};   // if set, workers come from it rather than from a pool per render
+};
+
+namespace detail {
+
+// Tile geometry for a width x height image
+class TileGrid {
+public:
+    TileGrid(unsigned int width, unsigned int height, unsigned int tile_size) :
+        width_{width}, height_{height}, tile_size_{std::max(tile_size, 1U)},
+        tiles_x_{(width + tile_size_ - 1) / tile_size_},
+        tiles_y_{(height + tile_size_ - 1) / tile_size_} {}
+
+    unsigned int size() const { return tiles_x_ * tiles_y_; }
+
+    struct Tile {
+        unsigned int x0, y0, x1, y1;
+    };
+
+    Tile operator[](unsigned int index) const {
+        auto const x0 = (index % tiles_x_) * tile_size_;
+        auto const y0 = (index / tiles_x_) * tile_size_;
+        return Tile {x0, y0, std::min(x0 + tile_size_, width_), std::min(y0 + tile_size_, height_)};
+    }
+
+private:
+    unsigned int width_;
+    unsigned int height_;
+    unsigned int tile_size_;
+    unsigned int tiles_x_;
+    unsigned int tiles_y_;
+};
+
+// Tiles follow the canvas's own tiles when it has tiled storage
+template <typename Canvas>
+unsigned int render_tile_size(RenderOptions const & options) {
+    if constexpr (requires { Canvas::storage_t::tile_size; }) {
+        return Canvas::storage_t::tile_size;
+    } else {
+        return options.tile_size;
+    }
+}
+
+// Unchecked view of the pixels in `tile`
+template <typename Canvas, typename Tile>
+auto tile_view(Canvas & image, Tile const & tile) {
+    if constexpr (requires { image.view(); }) {
+        return image.view(tile.x0, tile.y0, tile.x1 - tile.x0, tile.y1 - tile.y0);
+    } else {
+        return image.storage().tile(tile.x0, tile.y0).subview(0, 0, tile.x1 - tile.x0, tile.y1 - tile.y0);
+    }
+}
+
+template <typename Canvas, typename Tile>
+void render_tile(Camera const & camera, World const & world, Canvas & image, Tile const & tile) {
+    using pixel_t = typename Canvas::pixel_t;
+    auto const pixels = tile_view(image, tile);
+    for (auto y = 0U; y < pixels.height(); ++y) {
+        auto const row = pixels.row(y);
+        for (auto x = 0U; x < pixels.width(); ++x) {
+            auto const ray {ray_for_pixel(camera, tile.x0 + x, tile.y0 + y)};
+            row[x] = to_pixel<pixel_t>(color_at(world, ray));
+        }
+    }
+}
+
+// Whether `image` (a canvas, or anything else with a width and height) has room
+// for every pixel the camera renders.  The renders write through unchecked row
+// views, so each checks this once before it starts.
+template <typename Image>
+bool covers(Camera const & camera, Image const & image) {
+    return image.width() >= camera.hsize() && image.height() >= camera.vsize();
+}
+
+// Call render_tile(tile) for every tile of the image on options.threads
+// threads, merging what each tile counted and reporting progress.  Each tile
+// is a trace span.
+template <typename Canvas, typename RenderTile>
+RenderStats render_tiles(Camera const & camera, RenderOptions const & options, RenderTile && render_tile) {
+    TraceSpan const span {"render", "render"};
+    TileGrid const grid {camera.hsize(), camera.vsize(), render_tile_size<Canvas>(options)};
+    RenderStats stats {};
+    std::mutex stats_mutex;
+
+    std::optional<ProgressTracker> progress;
+    if (options.progress) {
+        auto const threads = parallel_threads(options.threads, options.pool);
+        progress.emplace(options.progress, options.progress_interval, grid.size(),
+                         static_cast<std::uint64_t>(camera.hsize()) * camera.vsize(),
+                         std::min(threads, grid.size()));
+    }
+
+    parallel_for(grid.size(), options.threads, [&](unsigned int index) {
+        TraceSpan const tile_span {"tile", "render", index};
+        auto const start = progress ? ProgressTracker::clock::now() : ProgressTracker::clock::time_point {};
+        [[maybe_unused]] auto const before = thread_render_stats();
+        auto const tile = grid[index];
+        render_tile(tile);
+        if constexpr (STATS_ENABLED) {
+            auto const tile_stats = thread_render_stats() - before;
+            std::lock_guard const lock {stats_mutex};
+            stats += tile_stats;
+        }
+        if (progress) {
+            progress->tile_done(static_cast<std::uint64_t>(tile.x1 - tile.x0) * (tile.y1 - tile.y0),
+                                ProgressTracker::clock::now() - start);
+        }
+    }, options.pool);
+    return stats;
+}
+
+} // namespace detail
+
+// Render into an existing canvas of at least hsize x vsize pixels, tile by
+// tile on several threads.  The result is identical to render(camera, world).
+// A canvas with TiledStorage is rendered in its own tiles, whatever
+// options.tile_size says.
+//
+// Returns what the render counted (see stats.h), all zero unless built with
+// RTC_ENABLE_STATS; or nothing, leaving the canvas untouched, if it is smaller
+// than hsize x vsize.
+template <typename Canvas>
+std::optional<RenderStats> render(Camera const & camera, World const & world, Canvas & image,
+                                  RenderOptions const & options) {
+    if (!detail::covers(camera, image)) {
+        return std::nullopt;
+    }
+    return detail::render_tiles<Canvas>(camera, options, [&](auto const & tile) {
+        detail::render_tile(camera, world, image, tile);
+    });
+}
+
+inline auto render(Camera const & camera, World const & world, RenderOptions const & options) {
+    auto image {canvas(camera.hsize(), camera.vsize())};
+    render(camera, world, image, options);
+    return image;
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_RENDER_H
@@ -0,0 +1,79 @@
+// Scenes from the chapter programs
+//
+// Each chapter 7-10 program renders one of these worlds, and the scene
+// benchmark runner renders all of them, so timings refer to exactly the
+// scenes the programs draw.  Every scene is viewed through chapter_camera().
+
+#ifndef RTC_LIB_SCENES_H
+#define RTC_LIB_SCENES_H
+
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "camera.h"
+#include "world.h"
+
+namespace rtc {
+
+struct Scene {
+    World world {};
+    Camera camera {};
+};
+
+// Looking at the origin from (0, 1.5, -5), with a field of view of pi/3
+Camera chapter_camera(unsigned int hsize, unsigned int vsize);
+
+// Chapter 7: three spheres in a room made of flattened spheres
+World chapter7_world();
+// Chapter 8: chapter 7 with a fourth sphere, to show its shadow
+World chapter8_world();
+// Chapter 9: chapter 7's spheres on a plane floor, with a plane wall
+World chapter9_world();
+
+// Chapter 10: patterns
+World chapter10_object_space_stripes_world();
+World chapter10_stripes_world();
+World chapter10_gradients_world();
+World chapter10_rings_world();
+World chapter10_checkers_world();
+World chapter10_radial_gradients_world();
+World chapter10_nested_patterns_world();
+World chapter10_tiled_floor_world();
+World chapter10_blended_patterns_world();
+World chapter10_perturbed_patterns_world();
+
+struct NamedScene {
+    std::string_view name;      // the chapter program's name, e.g. "chapter10_rings"
+    World (*make_world)();
+};
+
+// All of the above, in chapter order
+std::span<NamedScene const> named_scenes();
+
+// The named scene with a chapter_camera() of the given size, if there is one
+std::optional<Scene> make_scene(std::string_view name, unsigned int hsize, unsigned int vsize);
+
+// `text` as a whole number, if it is one (no sign, nothing after the digits)
+std::optional<unsigned int> parse_unsigned(std::string_view text);
+
+// The leading arguments of the scene programs: <scene> [width] [height]
+struct SceneArgs {
+    std::string name;
+    unsigned int width {400};
+    unsigned int height {300};
+};
+
+// Parse a scene program's command line, whose remaining arguments are described
+// by `more_usage` (e.g. "[threads]").  The scene must be one of named_scenes(),
+// so make_scene() succeeds with the result, and the width and height positive
+// whole numbers.  Otherwise writes the usage and the scene names, or what is
+// wrong, to `err` and returns nothing.
+std::optional<SceneArgs> parse_scene_args(int argc, char const * const * argv, std::string_view more_usage,
+                                          std::ostream & err);
+
+} // namespace rtc
+
+#endif // RTC_LIB_SCENES_H
@@ -0,0 +1,124 @@
+// Simplex Noise
+// Based on Stefan Gustavson's "Simplex noise demystified":
+// https://weber.itn.liu.se/~stegu/simplexnoise/simplexnoise.pdf
+//
+// In 3D each sample combines the contributions of the 4 corners of a simplex
+// (tetrahedron), instead of the 8 corners of a cube touched by Perlin noise.
+
+#ifndef RTC_LIB_SIMPLEX_NOISE_H
+#define RTC_LIB_SIMPLEX_NOISE_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "perlin_noise.h"
+
+namespace rtc {
+
+// Same interface as PerlinNoise: simplex() corresponds to perlin(),
+// octave_simplex() to octave_perlin() and octave_simplex3() to octave_perlin3().
+// Results are in the range [0, 1].
+class SimplexNoise {
+public:
+    SimplexNoise() = default;
+
+    inline double simplex(double x, double y, double z) const {
+        // Skewing and unskewing factors for 3D
+        constexpr double F3 {1.0 / 3.0};
+        constexpr double G3 {1.0 / 6.0};
+
+        // Skew the input space to determine which simplex cell we're in
+        double const s {(x + y + z) * F3};
+        double const i {detail::fast_floor(x + s)};
+        double const j {detail::fast_floor(y + s)};
+        double const k {detail::fast_floor(z + s)};
+
+        // Unskew the cell origin back to (x, y, z) space, and find the
+        // distances from the cell origin
+        double const t {(i + j + k) * G3};
+        double const x0 {x - (i - t)};
+        double const y0 {y - (j - t)};
+        double const z0 {z - (k - t)};
+
+        // Determine which of the 6 simplices we're in, from the rank order of the
+        // offsets: (i1, j1, k1) is the second corner, (i2, j2, k2) the third.
+        // Comparisons rather than branches, as the order is unpredictable.
+        int const i1 {(x0 >= y0) & (x0 >= z0)};  // x largest
+        int const j1 {(y0 > x0) & (y0 >= z0)};   // y largest
+        int const k1 {1 - i1 - j1};              // z largest
+        int const i2 {(x0 >= y0) | (x0 >= z0)};  // x not smallest
+        int const j2 {(y0 > x0) | (y0 >= z0)};   // y not smallest
+        int const k2 {2 - i2 - j2};              // z not smallest
+
+        // Offsets for the remaining corners, in (x, y, z) coordinates
+        double const x1 {x0 - i1 + G3};
+        double const y1 {y0 - j1 + G3};
+        double const z1 {z0 - k1 + G3};
+        double const x2 {x0 - i2 + 2.0 * G3};
+        double const y2 {y0 - j2 + 2.0 * G3};
+        double const z2 {z0 - k2 + 2.0 * G3};
+        double const x3 {x0 - 1.0 + 3.0 * G3};
+        double const y3 {y0 - 1.0 + 3.0 * G3};
+        double const z3 {z0 - 1.0 + 3.0 * G3};
+
+        // Hash the four corners with Ken Perlin's permutation table
+        auto const & p {detail::PERMUTATION};
+        int const ii {static_cast<int>(i) & 255};
+        int const jj {static_cast<int>(j) & 255};
+        int const kk {static_cast<int>(k) & 255};
+        int const h0 {p[ii      + p[jj      + p[kk     ]]]};
+        int const h1 {p[ii + i1 + p[jj + j1 + p[kk + k1]]]};
+        int const h2 {p[ii + i2 + p[jj + j2 + p[kk + k2]]]};
+        int const h3 {p[ii + 1  + p[jj + 1  + p[kk + 1 ]]]};
+
+        // Sum the contributions of the four corners.  The 32.0 factor scales
+        // the result to approximately [-1, 1].
+        double const n {corner_(h0, x0, y0, z0)
+                      + corner_(h1, x1, y1, z1)
+                      + corner_(h2, x2, y2, z2)
+                      + corner_(h3, x3, y3, z3)};
+
+        // Bound it to 0 - 1, like PerlinNoise::perlin()
+        return (32.0 * n + 1.0) / 2.0;
+    }
+
+    inline double octave_simplex(double x, double y, double z, int octaves, double persistence) const {
+        double total = 0;
+        double frequency = 1;
+        double amplitude = 1;
+        double max_value = 0;            // Used for normalizing result to 0.0 - 1.0
+
+        for(int i = 0; i < octaves; ++i) {
+            total += simplex(x * frequency, y * frequency, z * frequency) * amplitude;
+            max_value += amplitude;
+            amplitude *= persistence;
+            frequency *= 2;
+        }
+
+        return total / max_value;
+    }
+
+    // octave_simplex() at (x, y, z), (x, y, z + 1) and (x, y, z + 2)
+    inline std::array<double, 3> octave_simplex3(double x, double y, double z, int octaves, double persistence) const {
+        return {octave_simplex(x, y, z, octaves, persistence),
+                octave_simplex(x, y, z + 1.0, octaves, persistence),
+                octave_simplex(x, y, z + 2.0, octaves, persistence)};
+    }
+
+private:
+    // Contribution of one corner: a radially attenuated gradient
+    static inline double corner_(int hash, double x, double y, double z) {
+        double t {std::max(0.6 - x * x - y * y - z * z, 0.0)};
+        t *= t;
+        return t * t * detail::grad_branchless(hash, x, y, z);
+    }
+};
+
+inline SimplexNoise simplex_noise() {
+    return SimplexNoise {};
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_SIMPLEX_NOISE_H
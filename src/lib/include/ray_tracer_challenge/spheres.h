@@ -6,6 +6,7 @@
 #include "matrices.h"
 #include "intersections.h"
 #include "shapes.h"
+#include "stats.h"
 
 namespace rtc {
 
@@ -51,6 +52,8 @@ inline Vector local_normal_at(Sphere const & sphere, Point const & local_point)
 
 inline Intersections local_intersect(Sphere const & sphere,
                                      Ray const & local_ray) {
+    count_stat<&RenderStats::sphere_tests>();
+
     // TODO: A more stable algorithm at:
     // https://www.scratchapixel.com/lessons/3d-basic-rendering/minimal-ray-tracer-rendering-simple-shapes/ray-sphere-intersection.html
 
@@ -0,0 +1,96 @@
+// Render statistics
+//
+// With the RTC_ENABLE_STATS build option, the renderer counts the rays it
+// casts and the work they cause.  Each thread counts into its own thread_local
+// RenderStats, so counting is a plain increment with no sharing between
+// threads; render() merges each tile's counts into the totals it returns.
+//
+// Without RTC_ENABLE_STATS every count_stat() call compiles to nothing and
+// render() returns zeros.
+
+#ifndef RTC_LIB_STATS_H
+#define RTC_LIB_STATS_H
+
+#include <cstdint>
+
+namespace rtc {
+
+#ifdef RTC_ENABLE_STATS
+constexpr bool STATS_ENABLED {true};
+#else
+constexpr bool STATS_ENABLED {false};
+#endif
+
+struct RenderStats {
+    std::uint64_t primary_rays {};          // rays from the camera
+    std::uint64_t shadow_rays {};           // rays towards the light
+    std::uint64_t sphere_tests {};          // ray-sphere intersection tests
+    std::uint64_t plane_tests {};           // ray-plane intersection tests
+    std::uint64_t hits {};                  // camera rays that hit an object
+    std::uint64_t pattern_evaluations {};   // pattern lookups while shading, not counting nested patterns
+    std::uint64_t noise_evaluations {};     // perturbed pattern noise lookups, each giving three components
+    std::uint64_t matrix_inversions {};
+
+    RenderStats & operator+=(RenderStats const & rhs) {
+        primary_rays += rhs.primary_rays;
+        shadow_rays += rhs.shadow_rays;
+        sphere_tests += rhs.sphere_tests;
+        plane_tests += rhs.plane_tests;
+        hits += rhs.hits;
+        pattern_evaluations += rhs.pattern_evaluations;
+        noise_evaluations += rhs.noise_evaluations;
+        matrix_inversions += rhs.matrix_inversions;
+        return *this;
+    }
+
+    RenderStats & operator-=(RenderStats const & rhs) {
+        primary_rays -= rhs.primary_rays;
+        shadow_rays -= rhs.shadow_rays;
+        sphere_tests -= rhs.sphere_tests;
+        plane_tests -= rhs.plane_tests;
+        hits -= rhs.hits;
+        pattern_evaluations -= rhs.pattern_evaluations;
+        noise_evaluations -= rhs.noise_evaluations;
+        matrix_inversions -= rhs.matrix_inversions;
+        return *this;
+    }
+
+    friend bool operator==(RenderStats const &, RenderStats const &) = default;
+};
+
+inline RenderStats operator+(RenderStats lhs, RenderStats const & rhs) {
+    return lhs += rhs;
+}
+
+inline RenderStats operator-(RenderStats lhs, RenderStats const & rhs) {
+    return lhs -= rhs;
+}
+
+namespace detail {
+
+inline thread_local RenderStats thread_stats {};
+
+} // namespace detail
+
+// Add n to one of this thread's counters, e.g. count_stat<&RenderStats::hits>()
+template <std::uint64_t RenderStats::* Counter>
+inline void count_stat(std::uint64_t n = 1) {
+    if constexpr (STATS_ENABLED) {
+        detail::thread_stats.*Counter += n;
+    } else {
+        (void)n;
+    }
+}
+
+// Everything counted on this thread so far
+inline RenderStats thread_render_stats() {
+    if constexpr (STATS_ENABLED) {
+        return detail::thread_stats;
+    } else {
+        return {};
+    }
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_STATS_H
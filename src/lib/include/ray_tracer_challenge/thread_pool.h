@@ -0,0 +1,136 @@
+#ifndef RTC_LIB_THREAD_POOL_H
+#define RTC_LIB_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace rtc {
+
+// Fixed-size pool of worker threads.  Tasks run in submission order, on whichever
+// worker is free.  One pool can serve a render, its post-processing and the PNG
+// encoder (see RenderOptions::pool, PostProcessOptions::pool and write_png()), so
+// they do not each start threads of their own.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned int num_threads = std::thread::hardware_concurrency()) {
+        num_threads = std::max(num_threads, 1U);
+        workers_.reserve(num_threads);
+        for (auto i = 0U; i < num_threads; ++i) {
+            workers_.emplace_back([this] { run_(); });
+        }
+    }
+
+    // Completes all queued tasks before returning
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock {mutex_};
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto & worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool & operator=(ThreadPool const &) = delete;
+
+    auto size() const { return static_cast<unsigned int>(workers_.size()); }
+
+    template <typename Fn>
+    auto submit(Fn && fn) {
+        using result_t = std::invoke_result_t<Fn>;
+        auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<Fn>(fn));
+        auto future = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock {mutex_};
+            tasks_.emplace_back([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+private:
+    void run_() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock {mutex_};
+                cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;  // stopping, and nothing left to do
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+private:
+    std::vector<std::thread> workers_ {};
+    std::deque<std::function<void()>> tasks_ {};
+    std::mutex mutex_ {};
+    std::condition_variable cv_ {};
+    bool stopping_ {false};
+};
+
+// The number of threads parallel_for() uses for `threads`: with a pool, at most
+// its workers plus the caller, and all of them for 0; without one, 0 means one
+// per hardware thread
+inline unsigned int parallel_threads(unsigned int threads, ThreadPool const * pool = nullptr) {
+    if (pool) {
+        return threads == 0 ? pool->size() + 1 : std::min(threads, pool->size() + 1);
+    }
+    return threads == 0 ? std::max(std::thread::hardware_concurrency(), 1U) : threads;
+}
+
+// Call fn(i) for every i in [0, count), spread over parallel_threads(threads, pool)
+// threads.  Threads take the next index from a shared counter, so uneven work
+// balances itself.  The calling thread takes part; the others are workers of
+// `pool`, or of a pool made for the call if none is given.  `pool` must not be
+// one whose workers are all waiting on this call.
+template <typename Fn>
+void parallel_for(unsigned int count, unsigned int threads, Fn const & fn, ThreadPool * pool = nullptr) {
+    std::atomic<unsigned int> next {0};
+    auto const worker = [&] {
+        for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            fn(i);
+        }
+    };
+
+    threads = std::min(parallel_threads(threads, pool), count);
+    if (threads <= 1) {
+        worker();
+        return;
+    }
+
+    std::optional<ThreadPool> own_pool;
+    if (!pool) {
+        pool = &own_pool.emplace(threads - 1);
+    }
+    std::vector<std::future<void>> done;
+    done.reserve(threads - 1);
+    for (auto i = 1U; i < threads; ++i) {
+        done.push_back(pool->submit(worker));
+    }
+    worker();
+    for (auto & f : done) {
+        f.get();
+    }
+}
+
+} // namespace rtc
+
+#endif // RTC_LIB_THREAD_POOL_H
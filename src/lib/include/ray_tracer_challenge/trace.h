@@ -0,0 +1,173 @@
+// Tracing of render phases
+//
+// While a Tracer is started, TraceSpan objects record how long each phase of
+// the work took, and on which thread: building the scene, each tile of a
+// render, post-processing bands and encoding.  The spans can be written out
+// as Chrome trace-event JSON, for chrome://tracing or https://ui.perfetto.dev,
+// to see whether workers are starved, unevenly loaded or waiting on encoding.
+//
+// Each thread records into its own fixed-size ring buffer, allocated at its
+// first span, without locks, so tracing barely changes the timings it
+// measures.  When a buffer is full the oldest spans are overwritten.  With no
+// tracer started, a TraceSpan costs one atomic load.
+
+#ifndef RTC_LIB_TRACE_H
+#define RTC_LIB_TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace rtc {
+
+struct TraceEvent {
+    char const * name {};           // a string literal
+    char const * category {};       // a string literal
+    std::uint64_t start_ns {};      // since the tracer started
+    std::uint64_t duration_ns {};
+    std::int64_t index {-1};        // e.g. the tile or band number; -1 for none
+    unsigned int thread {};         // the tracer's number for the recording thread, from 0
+};
+
+class Tracer;
+
+namespace detail {
+
+// Single-writer ring buffer of one thread's events.  Readers must wait until
+// the writer has finished.
+class TraceBuffer {
+public:
+    TraceBuffer(unsigned int thread, std::size_t capacity) :
+        thread_{thread}, events_(std::max<std::size_t>(capacity, 1)) {}
+
+    void push(TraceEvent event) {
+        auto const n = written_.load(std::memory_order_relaxed);
+        event.thread = thread_;
+        events_[n % events_.size()] = event;
+        written_.store(n + 1, std::memory_order_release);
+    }
+
+    // The events still held, oldest first
+    std::vector<TraceEvent> events() const {
+        auto const n = written_.load(std::memory_order_acquire);
+        auto const kept = std::min<std::uint64_t>(n, events_.size());
+        std::vector<TraceEvent> result;
+        result.reserve(kept);
+        for (auto i = n - kept; i < n; ++i) {
+            result.push_back(events_[i % events_.size()]);
+        }
+        return result;
+    }
+
+    // Events overwritten because the buffer was full
+    std::uint64_t dropped() const {
+        auto const n = written_.load(std::memory_order_acquire);
+        return n > events_.size() ? n - events_.size() : 0;
+    }
+
+    unsigned int thread() const { return thread_; }
+
+private:
+    unsigned int thread_;
+    std::vector<TraceEvent> events_;
+    std::atomic<std::uint64_t> written_ {0};
+};
+
+inline std::atomic<Tracer *> active_tracer {nullptr};
+
+struct ThreadTraceBuffer {
+    std::uint64_t tracer_id {};     // 0: none
+    TraceBuffer * buffer {};
+};
+
+inline thread_local ThreadTraceBuffer thread_trace_buffer {};
+
+} // namespace detail
+
+// Collects spans from every thread while started.  Only one tracer can be
+// started at a time.  It must not be stopped or destroyed while spans are
+// still open, and its events should only be read once the traced work has
+// finished.
+class Tracer {
+public:
+    static constexpr std::size_t DEFAULT_EVENTS_PER_THREAD {1 << 16};
+
+    explicit Tracer(std::size_t events_per_thread = DEFAULT_EVENTS_PER_THREAD);
+    ~Tracer();
+
+    Tracer(Tracer const &) = delete;
+    Tracer & operator=(Tracer const &) = delete;
+
+    // Start recording spans, unless another tracer already is.  Returns
+    // whether this tracer is now the active one.
+    bool start();
+    void stop();
+
+    // Nanoseconds since the tracer was created
+    std::uint64_t now_ns() const {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin_).count());
+    }
+
+    void record(TraceEvent const & event) {
+        auto & cache = detail::thread_trace_buffer;
+        if (cache.tracer_id != id_) {
+            cache = {id_, add_thread_()};
+        }
+        cache.buffer->push(event);
+    }
+
+    // Everything recorded, thread by thread, each oldest first
+    std::vector<TraceEvent> events() const;
+
+    // Spans lost because a thread's buffer was full
+    std::uint64_t dropped() const;
+
+    // Chrome trace-event JSON: a "complete" event per span, and a name for
+    // each thread.  Returns false if the stream failed.
+    bool write_chrome_trace(std::ostream & os) const;
+
+private:
+    detail::TraceBuffer * add_thread_();
+
+    std::uint64_t id_;
+    std::chrono::steady_clock::time_point origin_;
+    std::size_t events_per_thread_;
+    mutable std::mutex mutex_ {};    // guards buffers_, not what is in them
+    std::vector<std::unique_ptr<detail::TraceBuffer>> buffers_ {};
+};
+
+// Records the time from its construction to its destruction as a span, if a
+// tracer was active when it was constructed
+class TraceSpan {
+public:
+    explicit TraceSpan(char const * name, char const * category, std::int64_t index = -1) :
+        tracer_{detail::active_tracer.load(std::memory_order_acquire)}, name_{name}, category_{category},
+        index_{index}, start_ns_{tracer_ ? tracer_->now_ns() : 0} {}
+
+    ~TraceSpan() {
+        if (tracer_) {
+            tracer_->record(TraceEvent {name_, category_, start_ns_, tracer_->now_ns() - start_ns_, index_});
+        }
+    }
+
+    TraceSpan(TraceSpan const &) = delete;
+    TraceSpan & operator=(TraceSpan const &) = delete;
+
+private:
+    Tracer * tracer_;
+    char const * name_;
+    char const * category_;
+    std::int64_t index_;
+    std::uint64_t start_ns_;
+};
+
+} // namespace rtc
+
+#endif // RTC_LIB_TRACE_H
@@ -9,6 +9,8 @@
 #include "lights.h"
 #include "transformations.h"
 #include "intersections.h"
+#include "profiling.h"
+#include "stats.h"
 
 namespace rtc {
 
@@ -102,6 +104,7 @@ inline bool is_shadowed(World const & world, Point const & point) {
     auto const direction = normalize(v);
 
     Ray const ray {point, direction};
+    count_stat<&RenderStats::shadow_rays>();
     auto intersections = intersect_world(world, ray);
 
     auto const h = hit(intersections);
@@ -120,17 +123,29 @@ inline auto shade_hit(World const & world, IntersectionComputation const & comps
                     shadowed);
 }
 
-inline Color color_at(World const & world, Ray const & ray) {
+// The colour seen along a ray, and the shape it hit (null if none)
+struct Sample {
+    Color color;
+    Shape const * object;
+};
+
+inline Sample sample_at(World const & world, Ray const & ray) {
     auto xs = intersect_world(world, ray);
     auto const i = hit(xs);
     if (i) {
+        count_stat<&RenderStats::hits>();
+        ObjectTimer const timer {*i->object(), ObjectPhase::shading};
         auto const comps = prepare_computations(*i, ray);
-        return shade_hit(world, comps);
+        return {shade_hit(world, comps), i->object()};
     } else {
-        return Color(0.0, 0.0, 0.0);
+        return {Color(0.0, 0.0, 0.0), nullptr};
     }
 }
 
+inline Color color_at(World const & world, Ray const & ray) {
+    return sample_at(world, ray).color;
+}
+
 } // namespace rtc
 
 #endif // RTC_LIB_WORLD_H
@@ -0,0 +1,187 @@
+#include "ray_tracer_challenge/mapped_canvas.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rtc {
+
+namespace {
+
+constexpr std::size_t PIXEL_SIZE {sizeof(Rgb32f)};
+
+// Little-endian colour PFM header, padded so that its length is a multiple of
+// the float size.  Zeros after the decimal point keep it a valid scale value.
+std::string aligned_pfm_header(unsigned int width, unsigned int height) {
+    auto const dims = "PF\n" + std::to_string(width) + ' ' + std::to_string(height) + "\n-1.0";
+    auto scale_zeros = (sizeof(float) - (dims.size() + 1) % sizeof(float)) % sizeof(float);
+    return dims + std::string(scale_zeros, '0') + '\n';
+}
+
+// Parse a PFM header, returning the width, height and size of the header in bytes
+struct PfmLayout {
+    unsigned int width {};
+    unsigned int height {};
+    std::size_t data_offset {};
+};
+
+std::optional<PfmLayout> parse_pfm_header(char const * data, std::size_t size) {
+    // The header is three whitespace-separated lines; it never needs more than a few dozen bytes
+    std::string const text {data, std::min<std::size_t>(size, 128)};
+    unsigned int width {};
+    unsigned int height {};
+    double scale {};
+    int consumed {};
+    if (text.size() < 3 || text.compare(0, 3, "PF\n") != 0
+        || std::sscanf(text.c_str() + 3, "%u %u %lf%n", &width, &height, &scale, &consumed) != 3) {
+        return std::nullopt;
+    }
+    auto const data_offset = 3 + static_cast<std::size_t>(consumed) + 1;
+    if (scale >= 0.0 || data_offset > text.size()) {
+        return std::nullopt;
+    }
+    return PfmLayout {width, height, data_offset};
+}
+
+std::size_t page_size() {
+    static auto const size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+} // namespace
+
+MappedPfmStorage::MappedPfmStorage(int fd, void * map, std::size_t map_size, std::size_t data_offset,
+                                   unsigned int width, unsigned int height) :
+    fd_{fd}, map_{map}, map_size_{map_size},
+    pixels_{reinterpret_cast<Rgb32f *>(static_cast<char *>(map) + data_offset)},
+    width_{width}, height_{height} {}
+
+MappedPfmStorage::MappedPfmStorage(MappedPfmStorage && other) noexcept :
+    fd_{std::exchange(other.fd_, -1)},
+    map_{std::exchange(other.map_, nullptr)},
+    map_size_{std::exchange(other.map_size_, 0)},
+    pixels_{std::exchange(other.pixels_, nullptr)},
+    width_{std::exchange(other.width_, 0)},
+    height_{std::exchange(other.height_, 0)} {}
+
+MappedPfmStorage & MappedPfmStorage::operator=(MappedPfmStorage && other) noexcept {
+    if (this != &other) {
+        close_();
+        fd_ = std::exchange(other.fd_, -1);
+        map_ = std::exchange(other.map_, nullptr);
+        map_size_ = std::exchange(other.map_size_, 0);
+        pixels_ = std::exchange(other.pixels_, nullptr);
+        width_ = std::exchange(other.width_, 0);
+        height_ = std::exchange(other.height_, 0);
+    }
+    return *this;
+}
+
+MappedPfmStorage::~MappedPfmStorage() {
+    close_();
+}
+
+void MappedPfmStorage::close_() {
+    if (map_) {
+        ::munmap(map_, map_size_);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+std::optional<MappedPfmStorage> MappedPfmStorage::create(std::string const & path,
+                                                         unsigned int width, unsigned int height) {
+    if constexpr (std::endian::native != std::endian::little) {
+        return std::nullopt;  // pixels are stored as native floats
+    }
+    if (width == 0 || height == 0) {
+        return std::nullopt;
+    }
+
+    auto const header = aligned_pfm_header(width, height);
+    auto const size = header.size() + static_cast<std::size_t>(width) * height * PIXEL_SIZE;
+
+    auto const fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    // A sparse file: blocks are only allocated as pixels are written
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    auto * const map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    std::copy(header.begin(), header.end(), static_cast<char *>(map));
+    return MappedPfmStorage {fd, map, size, header.size(), width, height};
+}
+
+std::optional<MappedPfmStorage> MappedPfmStorage::open(std::string const & path) {
+    if constexpr (std::endian::native != std::endian::little) {
+        return std::nullopt;
+    }
+
+    auto const fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    auto const size = static_cast<std::size_t>(st.st_size);
+    auto * const map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    auto const layout = parse_pfm_header(static_cast<char const *>(map), size);
+    if (!layout || layout->data_offset % alignof(Rgb32f) != 0
+        || size < layout->data_offset + static_cast<std::size_t>(layout->width) * layout->height * PIXEL_SIZE) {
+        ::munmap(map, size);
+        ::close(fd);
+        return std::nullopt;
+    }
+    return MappedPfmStorage {fd, map, size, layout->data_offset, layout->width, layout->height};
+}
+
+bool MappedPfmStorage::sync() {
+    return map_ && ::msync(map_, map_size_, MS_SYNC) == 0;
+}
+
+bool MappedPfmStorage::release_rows(unsigned int first, unsigned int last) {
+    last = std::min(last, height_);
+    if (!map_ || first >= last) {
+        return map_ != nullptr;
+    }
+
+    // Rows are stored bottom to top, so canvas rows [first, last) are file rows
+    // [height - last, height - first).  Dirty pages stay in the page cache when
+    // unmapped, so rounding out to whole pages loses nothing.
+    auto const row_size = static_cast<std::size_t>(width_) * PIXEL_SIZE;
+    auto const data = static_cast<std::size_t>(reinterpret_cast<char *>(pixels_) - static_cast<char *>(map_));
+    auto const page = page_size();
+    auto const begin = (data + (height_ - last) * row_size) / page * page;
+    auto const end = std::min(data + (height_ - first) * row_size, map_size_);
+    auto * const start = static_cast<char *>(map_) + begin;
+
+    return ::msync(start, end - begin, MS_ASYNC) == 0
+           && ::madvise(start, end - begin, MADV_DONTNEED) == 0;
+}
+
+} // namespace rtc
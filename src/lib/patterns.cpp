@@ -1,5 +1,6 @@
 #include "ray_tracer_challenge/patterns.h"
 #include "ray_tracer_challenge/color.h"
+#include "ray_tracer_challenge/profiling.h"
 #include "ray_tracer_challenge/shapes.h"
 #include "ray_tracer_challenge/tuples.h"
 
@@ -8,6 +9,9 @@ namespace rtc {
 Color pattern_at_shape(Pattern const & pattern,
                        Shape const & shape,
                        Point const & world_point) {
+    count_stat<&RenderStats::pattern_evaluations>();
+    ObjectTimer const timer {shape, ObjectPhase::pattern};
+
     // Convert world-space point to object-space point:
     auto const object_point {inverse(shape.transform()) * world_point};
     return pattern_at(pattern, object_point);
@@ -0,0 +1,138 @@
+#include "ray_tracer_challenge/perf_counters.h"
+
+#ifdef __linux__
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace rtc {
+
+#ifdef __linux__
+
+namespace {
+
+// In the order of PerfCounts' fields
+constexpr std::array<std::uint64_t, 4> HARDWARE_EVENTS {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int open_counter(std::uint64_t event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = event;
+    attr.disabled = 1;
+    attr.inherit = 1;           // and threads started later
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    auto const fd = syscall(SYS_perf_event_open, &attr, 0 /* this process */, -1 /* any cpu */, -1, 0);
+    return static_cast<int>(fd);
+}
+
+std::optional<PerfCounters::Reading> read_counter(int fd) {
+    PerfCounters::Reading reading {};
+    if (fd < 0 || ::read(fd, &reading, sizeof(reading)) != static_cast<ssize_t>(sizeof(reading))) {
+        return std::nullopt;
+    }
+    return reading;
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+        fds_[i] = open_counter(HARDWARE_EVENTS[i]);
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (auto const fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+// Counts from threads that have finished are kept apart from the counter's
+// own count, and PERF_EVENT_IOC_RESET leaves them be, so count from a
+// starting reading instead of resetting
+void PerfCounters::start() {
+    for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+        if (fds_[i] >= 0) {
+            start_[i] = read_counter(fds_[i]).value_or(Reading {});
+            ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+PerfCounts PerfCounters::stop() {
+    for (auto const fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    return read();
+}
+
+PerfCounts PerfCounters::read() const {
+    std::array<std::optional<std::uint64_t>, NUM_COUNTERS> counts {};
+    for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+        auto const now = read_counter(fds_[i]);
+        if (!now) {
+            continue;
+        }
+        auto const value = now->value - start_[i].value;
+        auto const enabled = now->time_enabled - start_[i].time_enabled;
+        auto const running = now->time_running - start_[i].time_running;
+        if (running == 0) {
+            // Never scheduled onto the hardware while enabled: unknown, unless never enabled at all
+            counts[i] = enabled == 0 ? std::optional<std::uint64_t> {0} : std::nullopt;
+        } else if (running < enabled) {
+            counts[i] = static_cast<std::uint64_t>(static_cast<double>(value) * static_cast<double>(enabled) /
+                                                   static_cast<double>(running));
+        } else {
+            counts[i] = value;
+        }
+    }
+    return PerfCounts {counts[0], counts[1], counts[2], counts[3]};
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::start() {}
+
+PerfCounts PerfCounters::stop() {
+    return {};
+}
+
+PerfCounts PerfCounters::read() const {
+    return {};
+}
+
+#endif
+
+bool PerfCounters::available() const {
+    for (auto const fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace rtc
@@ -0,0 +1,270 @@
+#include "ray_tracer_challenge/png.h"
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+#include <zlib.h>
+
+namespace rtc {
+
+namespace {
+
+constexpr std::array<std::uint8_t, 8> PNG_SIGNATURE {137, 80, 78, 71, 13, 10, 26, 10};
+
+// Filter types, as defined by the PNG specification
+enum Filter : std::uint8_t {
+    none = 0,
+    sub = 1,
+    up = 2,
+    average = 3,
+    paeth = 4,
+};
+
+constexpr unsigned int BYTES_PER_PIXEL {3};
+
+void put_u32(std::uint8_t * out, std::uint32_t value) {
+    out[0] = static_cast<std::uint8_t>(value >> 24);
+    out[1] = static_cast<std::uint8_t>(value >> 16);
+    out[2] = static_cast<std::uint8_t>(value >> 8);
+    out[3] = static_cast<std::uint8_t>(value);
+}
+
+std::uint8_t paeth_predictor(int a, int b, int c) {
+    auto const p = a + b - c;
+    auto const pa = std::abs(p - a);
+    auto const pb = std::abs(p - b);
+    auto const pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return static_cast<std::uint8_t>(a);
+    if (pb <= pc) return static_cast<std::uint8_t>(b);
+    return static_cast<std::uint8_t>(c);
+}
+
+// Filter one row with the given filter type.  `prior` is the previous row, or
+// zeros for the first row of the image.
+void filter_row(Filter filter, std::uint8_t const * row, std::uint8_t const * prior,
+                std::size_t size, std::uint8_t * out) {
+    for (std::size_t i = 0; i < size; ++i) {
+        int const a = i >= BYTES_PER_PIXEL ? row[i - BYTES_PER_PIXEL] : 0;
+        int const b = prior[i];
+        int const c = i >= BYTES_PER_PIXEL ? prior[i - BYTES_PER_PIXEL] : 0;
+        int predictor {0};
+        switch (filter) {
+            case none: predictor = 0; break;
+            case sub: predictor = a; break;
+            case up: predictor = b; break;
+            case average: predictor = (a + b) / 2; break;
+            case paeth: predictor = paeth_predictor(a, b, c); break;
+        }
+        out[i] = static_cast<std::uint8_t>(row[i] - predictor);
+    }
+}
+
+// Sum of the filtered bytes as signed values - the usual heuristic for choosing
+// a filter: smaller values tend to compress better.
+unsigned long filter_cost(std::uint8_t const * filtered, std::size_t size) {
+    unsigned long cost {0};
+    for (std::size_t i = 0; i < size; ++i) {
+        cost += static_cast<unsigned long>(std::abs(static_cast<std::int8_t>(filtered[i])));
+    }
+    return cost;
+}
+
+} // namespace
+
+PngWriter::PngWriter(std::ostream & os, unsigned int width, unsigned int height,
+                     ThreadPool * pool, int level, unsigned int band_rows) :
+    os_{os}, width_{width}, height_{height}, pool_{pool}, level_{level},
+    band_rows_{band_rows > 0 ? band_rows : DEFAULT_BAND_ROWS} {
+
+    os_.write(reinterpret_cast<char const *>(PNG_SIGNATURE.data()), PNG_SIGNATURE.size());
+
+    std::array<std::uint8_t, 13> ihdr {};
+    put_u32(&ihdr[0], width_);
+    put_u32(&ihdr[4], height_);
+    ihdr[8] = 8;   // bit depth
+    ihdr[9] = 2;   // colour type: RGB
+    ihdr[10] = 0;  // compression method: deflate
+    ihdr[11] = 0;  // filter method: adaptive
+    ihdr[12] = 0;  // interlace method: none
+    write_chunk_("IHDR", ihdr.data(), ihdr.size());
+
+    band_.reserve(static_cast<std::size_t>(band_rows_) * width_ * BYTES_PER_PIXEL);
+}
+
+PngWriter::~PngWriter() {
+    for (auto & band : pending_) {
+        band.wait();
+    }
+}
+
+void PngWriter::write_rows(std::uint8_t const * rgb, unsigned int num_rows) {
+    auto const row_size = static_cast<std::size_t>(width_) * BYTES_PER_PIXEL;
+    for (auto r = 0U; r < num_rows && rows_received_ < height_; ++r) {
+        band_.insert(band_.end(), rgb + r * row_size, rgb + (r + 1) * row_size);
+        ++rows_received_;
+        if (band_.size() == band_rows_ * row_size || rows_received_ == height_) {
+            submit_band_();
+        }
+    }
+    write_ready_bands_(false);
+}
+
+bool PngWriter::finish() {
+    if (finished_) {
+        return os_ && !failed_;
+    }
+    finished_ = true;
+
+    if (rows_received_ != height_) {
+        // Truncated: write the bands compressed so far, but leave the zlib
+        // stream and the file unterminated
+        failed_ = true;
+        write_ready_bands_(true);
+        os_.flush();
+        return false;
+    }
+    if (height_ == 0 || width_ == 0) {
+        // Still need a valid (empty) zlib stream
+        submit_band_();
+    }
+    write_ready_bands_(true);
+    write_chunk_("IEND", nullptr, 0);
+    os_.flush();
+    return os_ && !failed_;
+}
+
+void PngWriter::submit_band_() {
+    auto const row_size = static_cast<std::size_t>(width_) * BYTES_PER_PIXEL;
+    auto const last = rows_received_ == height_;
+
+    auto previous_row = previous_row_;
+    if (band_.size() >= row_size) {
+        previous_row_.assign(band_.end() - static_cast<std::ptrdiff_t>(row_size), band_.end());
+    }
+
+    auto job = [rows = std::move(band_), previous_row = std::move(previous_row),
+                width = width_, level = level_, last]() mutable {
+        return compress_band_(std::move(rows), std::move(previous_row), width, level, last);
+    };
+    band_ = {};
+    band_.reserve(band_rows_ * row_size);
+
+    if (pool_) {
+        pending_.push_back(pool_->submit(std::move(job)));
+    } else {
+        std::promise<Band> done;
+        done.set_value(job());
+        pending_.push_back(done.get_future());
+    }
+}
+
+// Write completed bands in order.  If `wait` is false, stop at the first band
+// that is still being compressed.
+void PngWriter::write_ready_bands_(bool wait) {
+    while (!pending_.empty()) {
+        auto & front = pending_.front();
+        if (!wait && front.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        auto const band = front.get();
+        pending_.pop_front();
+        failed_ = failed_ || !band.ok;
+
+        std::vector<std::uint8_t> idat;
+        idat.reserve(band.compressed.size() + 6);
+        if (!idat_started_) {
+            // zlib header: deflate, 32K window, default compression
+            idat.push_back(0x78);
+            idat.push_back(0x9c);
+            idat_started_ = true;
+        }
+        idat.insert(idat.end(), band.compressed.begin(), band.compressed.end());
+        adler_ = static_cast<std::uint32_t>(adler32_combine(adler_, band.adler,
+                                                            static_cast<z_off_t>(band.filtered_size)));
+        if (pending_.empty() && rows_received_ == height_) {
+            std::array<std::uint8_t, 4> trailer {};
+            put_u32(trailer.data(), adler_);
+            idat.insert(idat.end(), trailer.begin(), trailer.end());
+        }
+        write_chunk_("IDAT", idat.data(), idat.size());
+    }
+}
+
+// Filter and compress one band as a raw deflate fragment.  All but the last band
+// end with a sync flush, so the fragments can be concatenated into one stream.
+PngWriter::Band PngWriter::compress_band_(std::vector<std::uint8_t> rows,
+                                          std::vector<std::uint8_t> previous_row,
+                                          unsigned int width, int level, bool last) {
+    TraceSpan const span {"compress band", "encode"};
+    auto const row_size = static_cast<std::size_t>(width) * BYTES_PER_PIXEL;
+    auto const num_rows = row_size > 0 ? rows.size() / row_size : 0;
+
+    // Adaptive filtering: try each filter and keep the cheapest
+    std::vector<std::uint8_t> filtered(num_rows * (row_size + 1));
+    std::vector<std::uint8_t> candidate(row_size);
+    std::vector<std::uint8_t> zeros(row_size, 0);
+    if (previous_row.empty()) {
+        previous_row = zeros;
+    }
+    for (std::size_t r = 0; r < num_rows; ++r) {
+        auto const * row = rows.data() + r * row_size;
+        auto const * prior = r == 0 ? previous_row.data() : row - row_size;
+        auto * out = filtered.data() + r * (row_size + 1);
+
+        unsigned long best_cost {~0UL};
+        for (auto const filter : {none, sub, up, average, paeth}) {
+            filter_row(filter, row, prior, row_size, candidate.data());
+            auto const cost = filter_cost(candidate.data(), row_size);
+            if (cost < best_cost) {
+                best_cost = cost;
+                out[0] = filter;
+                std::memcpy(out + 1, candidate.data(), row_size);
+            }
+        }
+    }
+
+    Band band {};
+    band.filtered_size = filtered.size();
+    band.adler = static_cast<std::uint32_t>(adler32(adler32(0, nullptr, 0), filtered.data(),
+                                                    static_cast<uInt>(filtered.size())));
+
+    z_stream stream {};
+    if (deflateInit2(&stream, level, Z_DEFLATED, -15 /* raw deflate */, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        band.ok = false;
+        return band;
+    }
+    band.compressed.resize(deflateBound(&stream, static_cast<uLong>(filtered.size())) + 16);
+    stream.next_in = filtered.data();
+    stream.avail_in = static_cast<uInt>(filtered.size());
+    stream.next_out = band.compressed.data();
+    stream.avail_out = static_cast<uInt>(band.compressed.size());
+    // The output buffer holds the whole band, so one call must consume all the input
+    auto const result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    band.ok = (last ? result == Z_STREAM_END : result == Z_OK) && stream.avail_in == 0;
+    band.compressed.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return band;
+}
+
+void PngWriter::write_chunk_(char const * type, std::uint8_t const * data, std::size_t size) {
+    std::array<std::uint8_t, 8> header {};
+    put_u32(&header[0], static_cast<std::uint32_t>(size));
+    std::memcpy(&header[4], type, 4);
+
+    auto crc = crc32(0, &header[4], 4);
+    if (size > 0) {
+        crc = crc32(crc, data, static_cast<uInt>(size));
+    }
+    std::array<std::uint8_t, 4> trailer {};
+    put_u32(trailer.data(), static_cast<std::uint32_t>(crc));
+
+    os_.write(reinterpret_cast<char const *>(header.data()), header.size());
+    if (size > 0) {
+        os_.write(reinterpret_cast<char const *>(data), static_cast<std::streamsize>(size));
+    }
+    os_.write(reinterpret_cast<char const *>(trailer.data()), trailer.size());
+}
+
+} // namespace rtc
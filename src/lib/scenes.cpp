@@ -0,0 +1,503 @@
+#include "ray_tracer_challenge/scenes.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <numbers>
+
+#include "ray_tracer_challenge/lights.h"
+#include "ray_tracer_challenge/materials.h"
+#include "ray_tracer_challenge/patterns.h"
+#include "ray_tracer_challenge/planes.h"
+#include "ray_tracer_challenge/spheres.h"
+#include "ray_tracer_challenge/trace.h"
+#include "ray_tracer_challenge/transformations.h"
+
+namespace rtc {
+
+using std::numbers::pi;
+
+namespace {
+
+auto default_light() {
+    return point_light(point(-10.0, 10.0, -10.0), color(1.0, 1.0, 1.0));
+}
+
+// The floor, walls and three spheres of chapter 7
+void add_chapter7_objects(World & w) {
+    auto floor = sphere(1);
+    floor.set_transform(scaling(10.0, 0.01, 10.0));
+    floor.set_material(material());
+    floor.material().set_color(color(1.0, 0.9, 0.9));
+    floor.material().set_specular(0.0);
+
+    auto left_wall = sphere(2);
+    left_wall.set_transform(translation(0.0, 0.0, 5.0) *
+                            rotation_y(-pi / 4.0) *
+                            rotation_x(pi / 2.0) *
+                            scaling(10.0, 0.01, 10.0));
+    left_wall.material() = floor.material();
+
+    auto right_wall = sphere(3);
+    right_wall.set_transform(translation(0.0, 0.0, 5.0) *
+                             rotation_y(pi / 4.0) *
+                             rotation_x(pi / 2.0) *
+                             scaling(10.0, 0.01, 10.0));
+    right_wall.material() = floor.material();
+
+    w.add_object(floor);
+    w.add_object(left_wall);
+    w.add_object(right_wall);
+}
+
+// The three spheres common to chapters 7 to 10, with their chapter 7 materials
+Sphere middle_sphere() {
+    auto middle = sphere(4);
+    middle.set_transform(translation(-0.5, 1.0, 0.5));
+    middle.material() = material();
+    middle.material().set_color(color(0.1, 1.0, 0.5));
+    middle.material().set_diffuse(0.7);
+    middle.material().set_specular(0.3);
+    return middle;
+}
+
+Sphere right_sphere() {
+    auto right = sphere(5);
+    right.set_transform(translation(1.5, 0.5, -0.5) * scaling(0.5, 0.5, 0.5));
+    right.material() = material();
+    right.material().set_color(color(0.5, 1.0, 0.1));
+    right.material().set_diffuse(0.7);
+    right.material().set_specular(0.3);
+    return right;
+}
+
+Sphere left_sphere() {
+    auto left = sphere(6);
+    left.set_transform(translation(-1.5, 0.33, -0.75) * scaling(0.33, 0.33, 0.33));
+    left.material() = material();
+    left.material().set_color(color(1.0, 0.8, 0.1));
+    left.material().set_diffuse(0.7);
+    left.material().set_specular(0.3);
+    return left;
+}
+
+// The plane wall of chapter 9
+Plane back_wall() {
+    auto wall = plane();
+    wall.set_transform(rotation_x(pi / 2.0)
+                        .then(rotation_y(0.3))
+                        .then(translation(0.0, 0.0, 7.0)));
+    wall.set_material(material());
+    wall.material().set_color(Color(1.0, 0.8, 0.8));
+    wall.material().set_specular(0.0);
+    return wall;
+}
+
+// The stripes, gradients, rings, checkers and radial gradients scenes share
+// their objects and pattern transforms, except for the right sphere's
+void add_pattern_showcase(World & w,
+                          Pattern const & floor_pattern,
+                          Pattern const & wall_pattern,
+                          Pattern const & middle_pattern,
+                          Pattern const & right_pattern,
+                          Matrix<4> const & right_pattern_transform,
+                          Pattern const & left_pattern) {
+    auto floor = plane();
+    floor.set_material(material());
+    floor.material().set_color(color(1.0, 0.9, 0.9));
+    floor.material().set_specular(0.0);
+    floor.material().set_pattern(floor_pattern);
+    floor.material().pattern()->set_transform(rotation_y(pi / 4.0));
+    w.add_object(floor);
+
+    auto wall = back_wall();
+    wall.material().set_diffuse(0.3);
+    wall.material().set_pattern(wall_pattern);
+    w.add_object(wall);
+
+    auto middle = middle_sphere();
+    middle.material().set_pattern(middle_pattern);
+    middle.material().pattern()->set_transform(scaling(0.2, 0.2, 0.2).then(rotation_y(-pi / 8.0)));
+    w.add_object(middle);
+
+    auto right = right_sphere();
+    right.material().set_pattern(right_pattern);
+    right.material().pattern()->set_transform(right_pattern_transform);
+    w.add_object(right);
+
+    auto left = left_sphere();
+    left.set_transform(left.transform() * rotation_z(pi / 4.0));
+    left.material().set_pattern(left_pattern);
+    left.material().pattern()->set_transform(scaling(0.15, 0.15, 0.15));
+    w.add_object(left);
+
+    w.add_light(default_light());
+}
+
+auto const SMALL_TILTED = scaling(0.1, 0.1, 0.1).then(rotation_z(-pi / 6.0));
+auto const TILTED_OFFSET = rotation_z(-pi / 6.0).then(translation(0.5, 0.0, 0.0));
+
+constexpr std::array NAMED_SCENES {
+    NamedScene {"chapter7", chapter7_world},
+    NamedScene {"chapter8", chapter8_world},
+    NamedScene {"chapter9", chapter9_world},
+    NamedScene {"chapter10_object_space_stripes", chapter10_object_space_stripes_world},
+    NamedScene {"chapter10_stripes", chapter10_stripes_world},
+    NamedScene {"chapter10_gradients", chapter10_gradients_world},
+    NamedScene {"chapter10_rings", chapter10_rings_world},
+    NamedScene {"chapter10_checkers", chapter10_checkers_world},
+    NamedScene {"chapter10_radial_gradients", chapter10_radial_gradients_world},
+    NamedScene {"chapter10_nested_patterns", chapter10_nested_patterns_world},
+    NamedScene {"chapter10_tiled_floor", chapter10_tiled_floor_world},
+    NamedScene {"chapter10_blended_patterns", chapter10_blended_patterns_world},
+    NamedScene {"chapter10_perturbed_patterns", chapter10_perturbed_patterns_world},
+};
+
+} // namespace
+
+Camera chapter_camera(unsigned int hsize, unsigned int vsize) {
+    auto cam = camera(hsize, vsize, pi / 3.0);
+    cam.set_transform(view_transform(point(0.0, 1.5, -5.0),
+                                     point(0.0, 1.0, 0.0),
+                                     vector(0.0, 1.0, 0.0)));
+    return cam;
+}
+
+World chapter7_world() {
+    auto w = world();
+    add_chapter7_objects(w);
+    w.add_object(middle_sphere());
+    w.add_object(right_sphere());
+    w.add_object(left_sphere());
+    w.add_light(default_light());
+    return w;
+}
+
+World chapter8_world() {
+    auto w = chapter7_world();
+
+    auto left_up = sphere(7);
+    left_up.set_transform(translation(-2.0, 1.8, -1.0) * scaling(0.33, 0.33, 0.33));
+    left_up.material() = material();
+    left_up.material().set_color(color(1.0, 0.0, 0.0));
+    left_up.material().set_diffuse(0.7);
+    left_up.material().set_specular(0.6);
+    w.add_object(left_up);
+
+    return w;
+}
+
+World chapter9_world() {
+    auto w = world();
+
+    auto floor = plane();
+    floor.set_material(material());
+    floor.material().set_color(color(1.0, 0.9, 0.9));
+    floor.material().set_specular(0.0);
+
+    w.add_object(floor);
+    w.add_object(back_wall());
+    w.add_object(middle_sphere());
+    w.add_object(right_sphere());
+    w.add_object(left_sphere());
+    w.add_light(default_light());
+    return w;
+}
+
+World chapter10_object_space_stripes_world() {
+    auto w = world();
+
+    auto floor = plane();
+    floor.material().set_pattern(stripe_pattern(black, white));
+    w.add_object(floor);
+
+    // No rotation of object, scaling or rotation or translation of patterns
+    // should result in each sphere being exactly half black, half white.
+
+    auto middle = sphere(4);
+    middle.set_transform(translation(-0.5, 1.0, 0.5));
+    middle.material().set_pattern(stripe_pattern(black, white));
+    w.add_object(middle);
+
+    auto right = sphere(5);
+    right.set_transform(translation(1.5, 0.5, -0.5) * scaling(0.5, 0.5, 0.5));
+    right.material().set_pattern(stripe_pattern(black, white));
+    w.add_object(right);
+
+    auto left = sphere(6);
+    left.set_transform(translation(-1.5, 0.33, -0.75) * scaling(0.33, 0.33, 0.33));
+    left.material().set_pattern(stripe_pattern(black, white));
+    w.add_object(left);
+
+    w.add_light(default_light());
+    return w;
+}
+
+World chapter10_stripes_world() {
+    auto w = world();
+    add_pattern_showcase(w,
+                         stripe_pattern(red, white),
+                         stripe_pattern(black, red),
+                         stripe_pattern(blue, white),
+                         stripe_pattern(green, black), SMALL_TILTED,
+                         stripe_pattern(yellow, black));
+    return w;
+}
+
+World chapter10_gradients_world() {
+    auto w = world();
+    add_pattern_showcase(w,
+                         gradient_pattern(red, white),
+                         gradient_pattern(black, red),
+                         gradient_pattern(blue, white),
+                         gradient_pattern(green, white), TILTED_OFFSET,
+                         gradient_pattern(yellow, black));
+    return w;
+}
+
+World chapter10_rings_world() {
+    auto w = world();
+    add_pattern_showcase(w,
+                         ring_pattern(red, white),
+                         ring_pattern(black, red),
+                         ring_pattern(blue, white),
+                         ring_pattern(green, black), SMALL_TILTED,
+                         ring_pattern(yellow, black));
+    return w;
+}
+
+World chapter10_checkers_world() {
+    auto w = world();
+    add_pattern_showcase(w,
+                         checkers_pattern(red, white),
+                         checkers_pattern(black, red),
+                         checkers_pattern(blue, white),
+                         checkers_pattern(green, black), SMALL_TILTED,
+                         checkers_pattern(yellow, black));
+    return w;
+}
+
+World chapter10_radial_gradients_world() {
+    auto w = world();
+    add_pattern_showcase(w,
+                         radial_gradient_pattern(red, white),
+                         radial_gradient_pattern(black, red),
+                         radial_gradient_pattern(blue, white),
+                         radial_gradient_pattern(green, white), TILTED_OFFSET,
+                         radial_gradient_pattern(yellow, black, 1.0));
+    return w;
+}
+
+World chapter10_nested_patterns_world() {
+    auto w = world();
+
+    auto floor = plane();
+    floor.set_material(material());
+    floor.material().set_color(color(1.0, 0.9, 0.9));
+    floor.material().set_specular(0.0);
+    auto floor_pattern_1 = gradient_pattern(white, black);
+    auto floor_pattern_2 = gradient_pattern(red, green);
+    floor_pattern_2.set_transform(scaling(0.5, 0.5, 0.5).then(rotation_y(pi / 2.0)));
+    floor.material().set_pattern(stripe_pattern(floor_pattern_1, floor_pattern_2));
+    w.add_object(floor);
+
+    auto wall = plane();
+    wall.set_transform(rotation_x(pi / 2.0)
+                        .then(translation(0.0, 0.0, 7.0)));
+    wall.set_material(material());
+    wall.material().set_color(Color(1.0, 0.8, 0.8));
+    wall.material().set_diffuse(0.3);
+    wall.material().set_specular(0.0);
+    auto wall_pattern = ring_pattern(radial_gradient_pattern(yellow, black),
+                                     radial_gradient_pattern(black, yellow));
+    wall_pattern.set_transform(scaling(0.5, 0.5, 0.5));
+    wall.material().set_pattern(wall_pattern);
+    w.add_object(wall);
+
+    auto middle = middle_sphere();
+    auto middle_pattern = ring_pattern(blue, stripe_pattern(white, black));
+    set_pattern_transform(middle_pattern, scaling(0.2, 0.2, 0.2).then(rotation_x(pi / 2.0)));
+    middle.material().set_pattern(middle_pattern);
+    w.add_object(middle);
+
+    auto right = right_sphere();
+    auto right_pattern_2 = radial_gradient_pattern(white, black);
+    right_pattern_2.set_transform(rotation_x(pi / 2.0));
+    auto right_pattern = checkers_pattern(green, right_pattern_2);
+    set_pattern_transform(right_pattern, TILTED_OFFSET);
+    right.material().set_pattern(right_pattern);
+    w.add_object(right);
+
+    w.add_light(default_light());
+    return w;
+}
+
+World chapter10_tiled_floor_world() {
+    auto w = world();
+
+    auto floor = plane();
+    floor.set_material(material());
+    floor.material().set_color(color(1.0, 0.9, 0.9));
+    floor.material().set_specular(0.0);
+    auto const scale {0.3};
+    auto floor_pattern_1 = stripe_pattern(color(167/255.0, 83/255.0, 104/255.0), color(124/255.0, 41/255.0, 62/255.0));
+    floor_pattern_1.set_transform(scaling(scale, scale, scale).then(rotation_y(pi / 4.0)));
+    auto floor_pattern_2 = stripe_pattern(color(63/255.0, 63/255.0, 63/255.0), color(104/255.0, 104/255.0, 104/255.0));
+    floor_pattern_2.set_transform(scaling(scale, scale, scale).then(rotation_y(-pi / 4.0)));
+    floor.material().set_pattern(checkers_pattern(floor_pattern_1, floor_pattern_2));
+    w.add_object(floor);
+
+    w.add_light(default_light());
+    return w;
+}
+
+World chapter10_blended_patterns_world() {
+    auto w = world();
+
+    auto const color1 {white};
+    auto const color2 {color(40, 99, 40)};
+    auto const color3 {color(167, 83, 104)};
+    auto const color4 {color(124, 41, 62)};
+
+    auto floor = plane();
+    floor.set_material(material());
+    floor.material().set_diffuse(1.0);
+    floor.material().set_specular(0.0);
+    auto const scale {0.5};
+    auto floor_pattern_1 = stripe_pattern(color1, color2);
+    floor_pattern_1.set_transform(scaling(scale, scale, scale).then(rotation_y(pi / 4.0)));
+    auto floor_pattern_2 = stripe_pattern(color1, color2);
+    floor_pattern_2.set_transform(scaling(scale, scale, scale).then(rotation_y(-pi / 4.0)));
+    floor.material().set_pattern(blended_pattern(floor_pattern_1, floor_pattern_2));
+    w.add_object(floor);
+
+    auto middle = middle_sphere();
+    middle.material().set_diffuse(0.8);
+    middle.material().set_specular(0.6);
+    middle.material().set_shininess(100.0);
+    auto middle_pattern_1 = ring_pattern(color1, color3);
+    middle_pattern_1.set_transform(scaling(0.2, 0.2, 0.2));
+    auto middle_pattern_2 = ring_pattern(color1, color4);
+    middle_pattern_2.set_transform(scaling(0.2, 0.2, 0.2).then(rotation_x(-pi / 4.0)));
+    auto middle_pattern = blended_pattern(middle_pattern_1, middle_pattern_2);
+    middle_pattern.set_transform(rotation_y(pi / 4.0).then(rotation_x(-pi / 4.0)));
+    middle.material().set_pattern(middle_pattern);
+    w.add_object(middle);
+
+    w.add_light(point_light(point(10.0, 20.0, -10.0), color(1.0, 1.0, 1.0)));
+    return w;
+}
+
+World chapter10_perturbed_patterns_world() {
+    auto w = world();
+
+    auto floor = plane();
+    floor.set_material(material());
+    floor.material().set_color(color(1.0, 0.9, 0.9));
+    floor.material().set_ambient(0.2);
+    floor.material().set_specular(0.0);
+    auto floor_pattern_1 = perturbed_pattern(stripe_pattern(red, white), 2.0, 4, 0.9);
+    auto floor_pattern_2 = perturbed_pattern(stripe_pattern(red, white), 2.0, 4, 0.9);
+    auto const scale {0.4};
+    floor_pattern_1.set_transform(scaling(scale, scale, scale).then(rotation_y(pi / 4.0)));
+    floor_pattern_2.set_transform(scaling(scale, scale, scale).then(rotation_y(-pi / 4.0)));
+    auto floor_pattern = blended_pattern(floor_pattern_1, floor_pattern_2);
+    set_pattern_transform(floor_pattern, rotation_y(-pi / 8.0));
+    floor.material().set_pattern(floor_pattern);
+    w.add_object(floor);
+
+    auto middle = middle_sphere();
+    middle.material().set_diffuse(0.9);
+    middle.material().set_specular(0.7);
+    auto middle_pattern = perturbed_pattern(
+            stripe_pattern(color(13, 104, 53), color(15, 158, 79)), 2.0, 3, 0.8);
+    set_pattern_transform(middle_pattern, scaling(0.25, 0.25, 0.25)
+                              .then(rotation_z(-pi / 4.0))
+                              .then(rotation_y(-pi / 4.0)));
+    middle.material().set_pattern(middle_pattern);
+    w.add_object(middle);
+
+    auto right = right_sphere();
+    right.material().set_diffuse(0.9);
+    auto right_pattern = perturbed_pattern(
+            gradient_pattern(color(200, 40, 0), color(200, 180, 0)), 0.8, 4, 0.9);
+    set_pattern_transform(right_pattern, scaling(2.2, 2.2, 2.2)
+                                .then(rotation_z(pi / 6.0))
+                                .then(translation(2.0, 0.0, 0.0)));
+    right.material().set_pattern(right_pattern);
+    w.add_object(right);
+
+    auto left = left_sphere();
+    left.material().set_diffuse(0.9);
+    auto left_pattern = perturbed_pattern(
+            ring_pattern(color(199, 240, 194), color(95, 191, 95)), 1.5, 4, 0.9);
+    set_pattern_transform(left_pattern, scaling(0.3, 0.3, 0.3)
+                            .then(rotation_x(-pi / 3.0))
+                            .then(rotation_y(-0.2)));
+    left.material().set_pattern(left_pattern);
+    w.add_object(left);
+
+    w.add_light(default_light());
+    return w;
+}
+
+std::span<NamedScene const> named_scenes() {
+    return NAMED_SCENES;
+}
+
+std::optional<Scene> make_scene(std::string_view name, unsigned int hsize, unsigned int vsize) {
+    TraceSpan const span {"build scene", "scene"};
+    for (auto const & scene: NAMED_SCENES) {
+        if (scene.name == name) {
+            return Scene {scene.make_world(), chapter_camera(hsize, vsize)};
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<unsigned int> parse_unsigned(std::string_view text) {
+    unsigned int value {};
+    auto const * const end = text.data() + text.size();
+    auto const [stop, error] = std::from_chars(text.data(), end, value);
+    if (text.empty() || error != std::errc {} || stop != end) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<SceneArgs> parse_scene_args(int argc, char const * const * argv, std::string_view more_usage,
+                                          std::ostream & err) {
+    if (argc < 2) {
+        err << "Usage: " << argv[0] << " <scene> [width] [height] " << more_usage << "\n";
+        for (auto const & scene: NAMED_SCENES) {
+            err << "  " << scene.name << "\n";
+        }
+        return std::nullopt;
+    }
+
+    SceneArgs args {argv[1]};
+    auto const known = std::any_of(NAMED_SCENES.begin(), NAMED_SCENES.end(),
+                                   [&](auto const & scene) { return scene.name == args.name; });
+    if (!known) {
+        err << "Unknown scene: " << args.name << "\n";
+        return std::nullopt;
+    }
+    auto const parse_size = [&](int i, unsigned int & size) {
+        if (argc <= i) {
+            return true;
+        }
+        auto const value = parse_unsigned(argv[i]);
+        if (!value || *value == 0) {
+            err << "Bad size: " << argv[i] << " (width and height must be positive whole numbers)\n";
+            return false;
+        }
+        size = *value;
+        return true;
+    };
+    if (!parse_size(2, args.width) || !parse_size(3, args.height)) {
+        return std::nullopt;
+    }
+    return args;
+}
+
+} // namespace rtc
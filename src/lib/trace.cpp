@@ -0,0 +1,116 @@
+#include "ray_tracer_challenge/trace.h"
+
+#include <iomanip>
+
+namespace rtc {
+
+namespace {
+
+std::atomic<std::uint64_t> next_tracer_id {1};
+
+// Trace names are string literals from the code, but escape them anyway
+void write_json_string(std::ostream & os, char const * s) {
+    os << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') {
+            os << '\\' << *s;
+        } else if (static_cast<unsigned char>(*s) < 0x20) {
+            os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+               << static_cast<int>(*s) << std::dec << std::setfill(' ');
+        } else {
+            os << *s;
+        }
+    }
+    os << '"';
+}
+
+// Chrome trace timestamps are in microseconds
+void write_microseconds(std::ostream & os, std::uint64_t ns) {
+    os << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+}
+
+} // namespace
+
+Tracer::Tracer(std::size_t events_per_thread) :
+    id_{next_tracer_id.fetch_add(1, std::memory_order_relaxed)},
+    origin_{std::chrono::steady_clock::now()},
+    events_per_thread_{events_per_thread} {}
+
+Tracer::~Tracer() {
+    stop();
+}
+
+bool Tracer::start() {
+    Tracer * expected {nullptr};
+    return detail::active_tracer.compare_exchange_strong(expected, this, std::memory_order_acq_rel) ||
+           expected == this;
+}
+
+void Tracer::stop() {
+    Tracer * expected {this};
+    detail::active_tracer.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+}
+
+std::vector<TraceEvent> Tracer::events() const {
+    std::lock_guard const lock {mutex_};
+    std::vector<TraceEvent> result;
+    for (auto const & buffer : buffers_) {
+        auto const events = buffer->events();
+        result.insert(result.end(), events.begin(), events.end());
+    }
+    return result;
+}
+
+std::uint64_t Tracer::dropped() const {
+    std::lock_guard const lock {mutex_};
+    std::uint64_t total {0};
+    for (auto const & buffer : buffers_) {
+        total += buffer->dropped();
+    }
+    return total;
+}
+
+bool Tracer::write_chrome_trace(std::ostream & os) const {
+    auto const all = events();
+    unsigned int threads {0};
+    {
+        std::lock_guard const lock {mutex_};
+        threads = static_cast<unsigned int>(buffers_.size());
+    }
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char const * separator = "\n";
+    for (auto t = 0U; t < threads; ++t) {
+        os << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+           << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+        separator = ",\n";
+    }
+    for (auto const & event : all) {
+        os << separator << "{\"name\":";
+        write_json_string(os, event.name);
+        os << ",\"cat\":";
+        write_json_string(os, event.category);
+        os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":";
+        write_microseconds(os, event.start_ns);
+        os << ",\"dur\":";
+        write_microseconds(os, event.duration_ns);
+        if (event.index >= 0) {
+            os << ",\"args\":{\"index\":" << event.index << "}";
+        }
+        os << "}";
+        separator = ",\n";
+    }
+    os << "\n]}\n";
+    os.flush();
+    return static_cast<bool>(os);
+}
+
+// The first span a thread records for this tracer gives it a buffer
+detail::TraceBuffer * Tracer::add_thread_() {
+    std::lock_guard const lock {mutex_};
+    auto const thread = static_cast<unsigned int>(buffers_.size());
+    buffers_.push_back(std::make_unique<detail::TraceBuffer>(thread, events_per_thread_));
+    return buffers_.back().get();
+}
+
+} // namespace rtc
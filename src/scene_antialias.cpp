@@ -0,0 +1,76 @@
+// Render a chapter scene with adaptive supersampling, beside a plain render,
+// and print how many pixels were refined and what it cost.
+//
+//   scene_antialias <scene> [width] [height] [threshold] [grid]
+//
+// Writes <scene>.png and the anti-aliased <scene>_aa.png to the current
+// directory.
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <ray_tracer_challenge/antialias.h>
+#include <ray_tracer_challenge/png.h>
+#include <ray_tracer_challenge/scenes.h>
+
+using namespace rtc;
+
+namespace {
+
+template <typename Render>
+double seconds(Render && render) {
+    auto const start = std::chrono::steady_clock::now();
+    render();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    auto const args = parse_scene_args(argc, argv, "[threshold] [grid]", std::cerr);
+    if (!args) {
+        return 1;
+    }
+    auto const & [name, width, height] = *args;
+    Antialiasing antialiasing {};
+    if (argc > 4) antialiasing.threshold = std::atof(argv[4]);
+    if (argc > 5) {
+        auto const grid = parse_unsigned(argv[5]);
+        if (!grid || *grid == 0) {
+            std::cerr << "Bad grid: " << argv[5] << "\n";
+            return 1;
+        }
+        antialiasing.grid = *grid;
+    }
+
+    auto const scene = make_scene(name, width, height);
+    auto plain {canvas(width, height)};
+    auto antialiased {canvas(width, height)};
+    AntialiasStats stats;
+    auto const plain_seconds = seconds([&] { render(scene->camera, scene->world, plain, RenderOptions {}); });
+    auto const antialiased_seconds = seconds([&] {
+        render(scene->camera, scene->world, antialiased, stats, RenderOptions {}, antialiasing);
+    });
+
+    std::ofstream plain_file {name + ".png", std::ios::binary};
+    std::ofstream antialiased_file {name + "_aa.png", std::ios::binary};
+    if (!write_png(plain_file, plain) || !write_png(antialiased_file, antialiased)) {
+        std::cerr << "Failed to write output files\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Refined " << stats.refined_pixels << " of " << stats.pixels << " pixels ("
+              << 100.0 * stats.refined_fraction() << "%) with " << antialiasing.grid << "x" << antialiasing.grid
+              << " samples\n" << std::setprecision(2)
+              << "Rays: " << stats.samples << " ("
+              << static_cast<double>(stats.samples) / static_cast<double>(stats.pixels) << " per pixel)\n"
+              << std::setprecision(3)
+              << "Time: " << plain_seconds << " s plain, " << antialiased_seconds << " s anti-aliased ("
+              << std::setprecision(2) << antialiased_seconds / plain_seconds << "x)\n";
+    return 0;
+}
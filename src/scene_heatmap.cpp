@@ -0,0 +1,48 @@
+// Render a chapter scene with per-pixel cost recording.
+//
+//   scene_heatmap <scene> [width] [height] [cycles|tests]
+//
+// Writes <scene>.png, the cost heatmap <scene>_cost.png and the raw costs
+// <scene>_cost.pfm to the current directory.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <ray_tracer_challenge/cost_map.h>
+#include <ray_tracer_challenge/png.h>
+#include <ray_tracer_challenge/scenes.h>
+
+using namespace rtc;
+
+int main(int argc, char * argv[]) {
+    auto const args = parse_scene_args(argc, argv, "[cycles|tests]", std::cerr);
+    if (!args) {
+        return 1;
+    }
+    auto const & [name, width, height] = *args;
+    auto const metric = argc > 4 && std::string {argv[4]} == "tests" ? CostMetric::intersection_tests
+                                                                      : CostMetric::cycles;
+    if (metric == CostMetric::intersection_tests && !STATS_ENABLED) {
+        std::cerr << "Counting intersection tests needs a build with RTC_ENABLE_STATS\n";
+        return 1;
+    }
+
+    auto const scene = make_scene(name, width, height);
+    auto image {canvas(width, height)};
+    CostMap costs {width, height};
+    render(scene->camera, scene->world, image, costs, RenderOptions {}, metric);
+
+    std::ofstream image_file {name + ".png", std::ios::binary};
+    std::ofstream heatmap_file {name + "_cost.png", std::ios::binary};
+    std::ofstream raw_file {name + "_cost.pfm", std::ios::binary};
+    if (!write_png(image_file, image) || !write_png(heatmap_file, cost_heatmap(costs)) ||
+        !write_cost_pfm(raw_file, costs)) {
+        std::cerr << "Failed to write output files\n";
+        return 1;
+    }
+
+    std::cout << "Total cost: " << costs.sum(0, 0, width, height)
+              << (metric == CostMetric::cycles ? " cycles\n" : " intersection tests\n");
+    return 0;
+}
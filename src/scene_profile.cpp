@@ -0,0 +1,38 @@
+// Render a chapter scene with per-object profiling, and print which shapes
+// cost the most.  Needs a build with RTC_ENABLE_PROFILING.
+//
+//   scene_profile <scene> [width] [height] [threads]
+
+#include <iostream>
+#include <string>
+
+#include <ray_tracer_challenge/object_profile.h>
+#include <ray_tracer_challenge/scenes.h>
+
+using namespace rtc;
+
+int main(int argc, char * argv[]) {
+    auto const args = parse_scene_args(argc, argv, "[threads]", std::cerr);
+    if (!args) {
+        return 1;
+    }
+    auto const & [name, width, height] = *args;
+    if constexpr (!PROFILING_ENABLED) {
+        std::cerr << "Profiling needs a build with RTC_ENABLE_PROFILING\n";
+        return 1;
+    }
+
+    auto const thread_count = argc > 4 ? parse_unsigned(argv[4]) : 0U;
+    if (!thread_count) {
+        std::cerr << "Bad thread count: " << argv[4] << "\n";
+        return 1;
+    }
+    auto const threads = *thread_count;
+
+    auto const scene = make_scene(name, width, height);
+    auto image {canvas(width, height)};
+    ObjectProfile profile;
+    render(scene->camera, scene->world, image, profile, RenderOptions {.threads = threads});
+    write_object_report(std::cout, scene->world, profile);
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Render a chapter scene progressively, sampling each pixel until its error
+// is below a target, and show where the samples went.
+//
+//   scene_progressive <scene> [width] [height] [error target] [max samples]
+//
+// Writes <scene>_progressive.png and a heatmap of the samples per pixel,
+// <scene>_samples.png, to the current directory.
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <ray_tracer_challenge/accumulation.h>
+#include <ray_tracer_challenge/cost_map.h>
+#include <ray_tracer_challenge/png.h>
+#include <ray_tracer_challenge/scenes.h>
+
+using namespace rtc;
+
+int main(int argc, char * argv[]) {
+    auto const args = parse_scene_args(argc, argv, "[error target] [max samples]", std::cerr);
+    if (!args) {
+        return 1;
+    }
+    auto const & [name, width, height] = *args;
+    ProgressiveOptions progressive {};
+    if (argc > 4) progressive.error_target = std::atof(argv[4]);
+    if (argc > 5) {
+        auto const max_samples = parse_unsigned(argv[5]);
+        if (!max_samples || *max_samples == 0) {
+            std::cerr << "Bad sample cap: " << argv[5] << "\n";
+            return 1;
+        }
+        progressive.max_samples = *max_samples;
+    }
+
+    auto const scene = make_scene(name, width, height);
+    AccumulationBuffer buffer {width, height};
+    auto const stats = render(scene->camera, scene->world, buffer, progressive, RenderOptions {}).value();
+
+    CostMap samples {width, height};
+    for (auto y = 0U; y < height; ++y) {
+        for (auto x = 0U; x < width; ++x) {
+            samples.at(x, y) = buffer.at(x, y).count();
+        }
+    }
+
+    std::ofstream image_file {name + "_progressive.png", std::ios::binary};
+    std::ofstream samples_file {name + "_samples.png", std::ios::binary};
+    if (!write_png(image_file, buffer.resolve()) ||
+        !write_png(samples_file, cost_heatmap(samples, HeatmapOptions {.clip_percentile = 1.0}))) {
+        std::cerr << "Failed to write output files\n";
+        return 1;
+    }
+
+    auto const pixels = static_cast<double>(width) * height;
+    std::cout << std::fixed << std::setprecision(2)
+              << "Rounds: " << stats.rounds << "\n"
+              << "Samples: " << stats.samples << " (" << static_cast<double>(stats.samples) / pixels
+              << " per pixel, " << progressive.max_samples * pixels / static_cast<double>(stats.samples)
+              << "x fewer than the cap everywhere)\n"
+              << "Converged tiles: " << stats.converged_tiles << " of " << stats.tiles << "\n";
+    return 0;
+}
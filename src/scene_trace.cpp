@@ -0,0 +1,129 @@
+// Render a chapter scene with tracing, from building the scene to writing the PNG.
+//
+//   scene_trace <scene> [width] [height] [threads]
+//
+// Writes <scene>.png and the trace <scene>_trace.json to the current
+// directory.  Open the trace in chrome://tracing or https://ui.perfetto.dev.
+//
+// Also prints the wall time, hardware counters (see perf_counters.h) and heap
+// allocations (see alloc_tracking.h) of each phase: building the scene,
+// rendering, post-processing and encoding.
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include <ray_tracer_challenge/alloc_tracking.h>
+#include <ray_tracer_challenge/perf_counters.h>
+#include <ray_tracer_challenge/png.h>
+#include <ray_tracer_challenge/post_process.h>
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/scenes.h>
+#include <ray_tracer_challenge/trace.h>
+
+using namespace rtc;
+
+namespace {
+
+void print_count(std::optional<std::uint64_t> count) {
+    std::cout << std::setw(16);
+    if (count) {
+        std::cout << *count;
+    } else {
+        std::cout << "-";
+    }
+}
+
+// Run fn() as one phase, and print its wall time and counts
+template <typename Fn>
+auto measure(PerfCounters & counters, char const * phase, Fn && fn) {
+    auto const start = std::chrono::steady_clock::now();
+    AllocationScope const allocations;
+    counters.start();
+    auto result = fn();
+    auto const counts = counters.stop();
+    [[maybe_unused]] auto const allocated = allocations.counts();
+    std::chrono::duration<double, std::milli> const wall = std::chrono::steady_clock::now() - start;
+
+    std::cout << std::left << std::setw(14) << phase << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << wall.count();
+    print_count(counts.cycles);
+    print_count(counts.instructions);
+    std::cout << std::setw(6) << std::setprecision(2);
+    if (auto const ipc = counts.ipc()) {
+        std::cout << *ipc;
+    } else {
+        std::cout << "-";
+    }
+    print_count(counts.cache_misses);
+    print_count(counts.branch_misses);
+    if constexpr (ALLOC_TRACKING_ENABLED) {
+        std::cout << std::setw(12) << allocated.allocations << std::setw(12) << allocated.bytes / 1024;
+    }
+    std::cout << "\n";
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char * argv[]) {
+    auto const args = parse_scene_args(argc, argv, "[threads]", std::cerr);
+    if (!args) {
+        return 1;
+    }
+    auto const & [name, width, height] = *args;
+    auto const thread_count = argc > 4 ? parse_unsigned(argv[4]) : 0U;
+    if (!thread_count) {
+        std::cerr << "Bad thread count: " << argv[4] << "\n";
+        return 1;
+    }
+    auto const threads = *thread_count;
+
+    Tracer tracer;
+    tracer.start();
+    PerfCounters counters;
+    if (!counters.available()) {
+        std::cerr << "Hardware performance counters are unavailable\n";
+    }
+    std::cout << std::left << std::setw(14) << "phase" << std::right << std::setw(10) << "wall ms"
+              << std::setw(16) << "cycles" << std::setw(16) << "instructions" << std::setw(6) << "IPC"
+              << std::setw(16) << "cache misses" << std::setw(16) << "branch misses";
+    if constexpr (ALLOC_TRACKING_ENABLED) {
+        std::cout << std::setw(12) << "allocations" << std::setw(12) << "alloc KiB";
+    }
+    std::cout << "\n";
+
+    auto const scene = measure(counters, "build scene", [&] { return make_scene(name, width, height); });
+
+    // One pool of workers for every phase; the calling thread makes up the rest
+    ThreadPool pool {parallel_threads(threads) - 1};
+    auto image {canvas(width, height)};
+    measure(counters, "render", [&] {
+        return render(scene->camera, scene->world, image, RenderOptions {.threads = threads, .pool = &pool});
+    });
+    auto const display = measure(counters, "post process", [&] {
+        return post_process(image, PostProcessOptions {.threads = threads, .pool = &pool});
+    });
+    auto const written = measure(counters, "encode", [&] {
+        std::ofstream image_file {name + ".png", std::ios::binary};
+        return write_png(image_file, display, &pool);
+    });
+    if (!written) {
+        std::cerr << "Failed to write " << name << ".png\n";
+        return 1;
+    }
+
+    tracer.stop();
+    std::ofstream trace_file {name + "_trace.json"};
+    if (!tracer.write_chrome_trace(trace_file)) {
+        std::cerr << "Failed to write " << name << "_trace.json\n";
+        return 1;
+    }
+    if (auto const dropped = tracer.dropped(); dropped > 0) {
+        std::cerr << dropped << " spans were dropped\n";
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+// Performance regression tests
+//
+// Each test renders a small reference scene and checks that
+//  - the image matches its golden reference (test/data/perf/<name>.pfm) to
+//    within a PSNR bound, so speed work cannot quietly change the output, and
+//  - its normalized throughput stays within a tolerance of the checked-in
+//    baseline (test/data/perf/baseline.json).
+//
+// Throughput is camera rays per second on one thread, divided by the rate of a
+// fixed calibration loop timed alongside it, so the baseline carries over
+// (roughly) between machines.  It is only checked in optimized builds without
+// any of the instrumentation options, since those are what the baseline was
+// measured with.  The throughput tests are disabled unless the build is
+// configured with -DRTC_PERF_TESTS=ON, since a busy machine makes them fail;
+// the image tests always run.
+//
+// These tests have the ctest label "performance":
+//
+//    ctest -L performance      # only these
+//    ctest -LE performance     # everything else
+//
+// After an intended change to the images or the speed, rewrite the references
+// and baseline by running the tests with RTC_UPDATE_PERF_BASELINE=1 (and
+// --gtest_also_run_disabled_tests, without RTC_PERF_TESTS).
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <string>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <ray_tracer_challenge/alloc_tracking.h>
+#include <ray_tracer_challenge/pfm.h>
+#include <ray_tracer_challenge/profiling.h>
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/scenes.h>
+#include <ray_tracer_challenge/stats.h>
+
+using namespace rtc;
+
+namespace {
+
+constexpr auto pi = std::numbers::pi;
+constexpr double min_psnr {60.0};       // dB; the references are stored to single precision
+constexpr int repetitions {5};          // throughput is the best of these
+
+// Name of a throughput test, disabled unless RTC_PERF_TESTS is defined
+#ifdef RTC_PERF_TESTS
+#define THROUGHPUT_TEST(name) name
+#else
+#define THROUGHPUT_TEST(name) DISABLED_##name
+#endif
+
+#ifdef NDEBUG
+constexpr bool OPTIMIZED_BUILD {true};
+#else
+constexpr bool OPTIMIZED_BUILD {false};
+#endif
+
+std::filesystem::path const data_dir {RTC_PERF_DATA_DIR};
+std::filesystem::path const baseline_path {data_dir / "baseline.json"};
+
+bool updating() {
+    auto const * update = std::getenv("RTC_UPDATE_PERF_BASELINE");
+    return update && std::string {update} == "1";
+}
+
+// Peak signal-to-noise ratio of `image` against `reference`, over colour
+// components clamped to [0, 1] as they would be written out; infinite when
+// they are the same
+template <typename Canvas, typename Reference>
+double psnr(Canvas const & image, Reference const & reference) {
+    double squared_error {0.0};
+    for (auto y = 0U; y < image.height(); ++y) {
+        for (auto x = 0U; x < image.width(); ++x) {
+            auto const a = *pixel_at(image, x, y);
+            auto const b = *pixel_at(reference, x, y);
+            double const differences[] {
+                std::clamp(a.red(), 0.0, 1.0) - std::clamp(b.red(), 0.0, 1.0),
+                std::clamp(a.green(), 0.0, 1.0) - std::clamp(b.green(), 0.0, 1.0),
+                std::clamp(a.blue(), 0.0, 1.0) - std::clamp(b.blue(), 0.0, 1.0)};
+            for (auto const d : differences) {
+                squared_error += d * d;
+            }
+        }
+    }
+    auto const mse = squared_error / (3.0 * image.width() * image.height());
+    return mse > 0.0 ? 10.0 * std::log10(1.0 / mse) : std::numeric_limits<double>::infinity();
+}
+
+constexpr std::uint64_t calibration_iterations {20'000'000};
+
+// Seconds for a fixed floating point loop that uses none of the library, as the
+// unit throughput is measured in
+double calibration_seconds() {
+    auto const start = std::chrono::steady_clock::now();
+    double x {0.5};
+    double sum {0.0};
+    for (std::uint64_t i = 0; i < calibration_iterations; ++i) {
+        x = 3.9 * x * (1.0 - x);
+        sum += std::sqrt(x);
+    }
+    auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    volatile auto const sink = sum;
+    static_cast<void>(sink);
+    return seconds;
+}
+
+// Seconds to render on one thread
+double render_seconds(Camera const & camera, World const & world) {
+    auto const start = std::chrono::steady_clock::now();
+    auto const image = render(camera, world, RenderOptions {1});
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Camera rays per calibration iteration, rendering on one thread.  After an
+// untimed render to warm the caches, calibration and render repetitions
+// alternate, so a change in machine load affects both, and the best of each is
+// taken.
+double measure_throughput(Camera const & camera, World const & world) {
+    render_seconds(camera, world);
+    auto best_calibration = std::numeric_limits<double>::infinity();
+    auto best_render = std::numeric_limits<double>::infinity();
+    for (auto r = 0; r < repetitions; ++r) {
+        best_calibration = std::min(best_calibration, calibration_seconds());
+        best_render = std::min(best_render, render_seconds(camera, world));
+    }
+    auto const rays = static_cast<double>(camera.hsize()) * camera.vsize();
+    return (rays / best_render) / (static_cast<double>(calibration_iterations) / best_calibration);
+}
+
+void check_image(std::string const & name, Canvas<Color> const & image) {
+    auto const path = data_dir / (name + ".pfm");
+    if (updating()) {
+        std::ofstream out {path, std::ios::binary};
+        ASSERT_TRUE(write_pfm(out, image)) << path;
+        return;
+    }
+    std::ifstream in {path, std::ios::binary};
+    auto const reference = read_pfm(in);
+    ASSERT_TRUE(reference) << "cannot read " << path;
+    ASSERT_EQ(reference->width(), image.width());
+    ASSERT_EQ(reference->height(), image.height());
+    EXPECT_GE(psnr(image, *reference), min_psnr) << name << " no longer matches " << path;
+}
+
+void check_throughput(std::string const & name, Camera const & camera, World const & world) {
+    if constexpr (!OPTIMIZED_BUILD || STATS_ENABLED || PROFILING_ENABLED || ALLOC_TRACKING_ENABLED) {
+        GTEST_SKIP() << "throughput is only checked in optimized builds without instrumentation";
+    }
+    boost::property_tree::ptree baseline;
+    if (std::filesystem::exists(baseline_path)) {
+        boost::property_tree::read_json(baseline_path.string(), baseline);
+    }
+
+    auto const throughput = measure_throughput(camera, world);
+    auto const key = "throughput." + name;
+    if (updating()) {
+        baseline.put(key, throughput);
+        if (!baseline.get_optional<double>("tolerance")) {
+            baseline.put("tolerance", 0.25);
+        }
+        boost::property_tree::write_json(baseline_path.string(), baseline);
+        return;
+    }
+
+    auto const expected = baseline.get_optional<double>(key);
+    ASSERT_TRUE(expected) << "no baseline for " << name << " in " << baseline_path;
+    auto const tolerance = baseline.get<double>("tolerance");
+    auto const change = throughput / *expected - 1.0;
+    ::testing::Test::RecordProperty("throughput", std::to_string(throughput));
+    EXPECT_GE(change, -tolerance) << name << " is " << -100.0 * change << "% slower than the baseline";
+    if (change > tolerance) {
+        std::cout << name << " is " << 100.0 * change << "% faster than the baseline; "
+                  << "consider updating it with RTC_UPDATE_PERF_BASELINE=1\n";
+    }
+}
+
+Camera default_world_camera(unsigned int hsize, unsigned int vsize) {
+    auto c = camera(hsize, vsize, pi / 2.0);
+    c.transform() = view_transform(point(0.0, 0.0, -5.0), point(0.0, 0.0, 0.0), vector(0.0, 1.0, 0.0));
+    return c;
+}
+
+} // namespace
+
+// The default world's two spheres
+TEST(TestPerfRegression, default_world_image) {
+    check_image("default_world", render(default_world_camera(80, 60), default_world()));
+}
+
+TEST(TestPerfRegression, THROUGHPUT_TEST(default_world_throughput)) {
+    check_throughput("default_world", default_world_camera(160, 120), default_world());
+}
+
+// The chapter 9 scene: spheres on planes, with shadows
+TEST(TestPerfRegression, chapter9_image) {
+    auto const scene = make_scene("chapter9", 80, 60);
+    ASSERT_TRUE(scene);
+    check_image("chapter9", render(scene->camera, scene->world));
+}
+
+TEST(TestPerfRegression, THROUGHPUT_TEST(chapter9_throughput)) {
+    auto const scene = make_scene("chapter9", 160, 120);
+    ASSERT_TRUE(scene);
+    check_throughput("chapter9", scene->camera, scene->world);
+}
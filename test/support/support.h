@@ -3,6 +3,14 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <numbers>
+#include <string>
+
+#include <unistd.h>
+
+#include <ray_tracer_challenge/camera.h>
+
 template <typename T, typename U>
 ::testing::AssertionResult AlmostEqual(T const & a, U const & b, double epsilon=1e-5) {
     if (almost_equal(a, b, epsilon)) {
@@ -12,4 +20,42 @@ template <typename T, typename U>
     }
 }
 
+// A camera looking at the origin from `distance` along -z, as the book's
+// render tests view the default world
+inline rtc::Camera test_camera(unsigned int hsize, unsigned int vsize, double field_of_view = std::numbers::pi / 2.0,
+                               double distance = 5.0) {
+    auto c = rtc::camera(hsize, vsize, field_of_view);
+    c.transform() = rtc::view_transform(rtc::point(0.0, 0.0, -distance), rtc::point(0.0, 0.0, 0.0),
+                                        rtc::vector(0.0, 1.0, 0.0));
+    return c;
+}
+
+// Close enough to the default world for its outer sphere to fill most of the image
+inline rtc::Camera close_test_camera(unsigned int hsize, unsigned int vsize) {
+    return test_camera(hsize, vsize, std::numbers::pi / 3.0, 3.0);
+}
+
+// A path in the temporary directory, with the file (and any files named by
+// appending a suffix to it) removed when the test ends
+class TempFile {
+public:
+    explicit TempFile(std::string const & name) :
+        path_{std::filesystem::temp_directory_path() / ("rtc_" + std::to_string(::getpid()) + "_" + name)} {}
+
+    ~TempFile() {
+        std::filesystem::remove(path_);
+        for (auto const * suffix : {".pfm", ".manifest", ".manifest.tmp"}) {
+            std::filesystem::remove(path() + suffix);
+        }
+    }
+
+    TempFile(TempFile const &) = delete;
+    TempFile & operator=(TempFile const &) = delete;
+
+    std::string path() const { return path_.string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
 #endif // TEST_SUPPORT_SUPPORT_H
@@ -0,0 +1,144 @@
+// Progressive rendering with an accumulation buffer
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include <ray_tracer_challenge/accumulation.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+namespace {
+
+std::uint64_t total_samples(AccumulationBuffer const & buffer) {
+    std::uint64_t total {0};
+    for (auto y = 0U; y < buffer.height(); ++y) {
+        for (auto x = 0U; x < buffer.width(); ++x) {
+            total += buffer.at(x, y).count();
+        }
+    }
+    return total;
+}
+
+} // namespace
+
+// The running mean and variance match those computed directly
+TEST(TestAccumulation, running_mean_and_variance) {
+    PixelAccumulator pixel;
+    EXPECT_EQ(pixel.count(), 0U);
+    EXPECT_EQ(pixel.error(), std::numeric_limits<double>::infinity());
+    pixel.add(color(1.0, 0.0, 0.5));
+    EXPECT_EQ(pixel.error(), std::numeric_limits<double>::infinity());
+    pixel.add(color(0.0, 0.0, 0.5));
+    pixel.add(color(0.5, 0.0, 0.5));
+    pixel.add(color(0.5, 0.0, 0.5));
+
+    EXPECT_EQ(pixel.count(), 4U);
+    EXPECT_TRUE(almost_equal(pixel.mean(), color(0.5, 0.0, 0.5)));
+    EXPECT_TRUE(almost_equal(pixel.variance(), color(0.5 / 3.0, 0.0, 0.0)));
+    EXPECT_DOUBLE_EQ(pixel.error(), std::sqrt(0.5 / 3.0 / 4.0));
+}
+
+// Pixels that see only the background stop at the minimum; those on the
+// sphere's outline keep going
+TEST(TestAccumulation, samples_go_to_noisy_pixels) {
+    AccumulationBuffer buffer {20, 15};
+    auto const stats = render(close_test_camera(20, 15), default_world(), buffer,
+                              ProgressiveOptions {.min_samples = 8, .max_samples = 64}, RenderOptions {1, 4});
+    ASSERT_TRUE(stats);
+
+    EXPECT_EQ(buffer.at(0, 0).count(), 8U);
+    EXPECT_EQ(buffer.at(0, 0).error(), 0.0);
+    auto most = 0U;
+    for (auto x = 0U; x < 20; ++x) {
+        most = std::max(most, buffer.at(x, 7).count());
+    }
+    EXPECT_EQ(most, 64U);
+    EXPECT_EQ(stats->samples, total_samples(buffer));
+    EXPECT_GT(stats->rounds, 1U);
+}
+
+// Rendering stops once every pixel has met the error target or the sample cap
+TEST(TestAccumulation, stops_when_converged) {
+    AccumulationBuffer buffer {20, 15};
+    ProgressiveOptions const options {.error_target = 0.01, .max_samples = 32};
+    auto const stats = render(close_test_camera(20, 15), default_world(), buffer, options, RenderOptions {2, 4});
+    ASSERT_TRUE(stats);
+
+    EXPECT_EQ(stats->tiles, 20U);
+    EXPECT_EQ(stats->converged_tiles, stats->tiles);
+    EXPECT_EQ(stats->max_error, 0.0);
+    for (auto y = 0U; y < 15; ++y) {
+        for (auto x = 0U; x < 20; ++x) {
+            auto const & pixel = buffer.at(x, y);
+            EXPECT_TRUE(pixel.count() == 32 || (pixel.count() >= 8 && pixel.error() <= 0.01)) << x << ", " << y;
+        }
+    }
+}
+
+// A sample budget ends the render early, leaving some tiles unconverged
+TEST(TestAccumulation, sample_budget) {
+    AccumulationBuffer buffer {20, 15};
+    auto const stats = render(close_test_camera(20, 15), default_world(), buffer,
+                              ProgressiveOptions {.error_target = 0.0001, .sample_budget = 4000},
+                              RenderOptions {1, 4});
+    ASSERT_TRUE(stats);
+    EXPECT_GE(stats->samples, 4000U);
+    EXPECT_LT(stats->samples, 20U * 15U * 256U);
+    EXPECT_LT(stats->converged_tiles, stats->tiles);
+    EXPECT_GT(stats->max_error, 0.0001);
+}
+
+// A buffer too small for the camera is reported and left untouched
+TEST(TestAccumulation, buffer_too_small) {
+    AccumulationBuffer buffer {20, 14};
+    auto const stats = render(close_test_camera(20, 15), default_world(), buffer, ProgressiveOptions {},
+                              RenderOptions {1, 4});
+    EXPECT_FALSE(stats);
+    EXPECT_EQ(total_samples(buffer), 0U);
+}
+
+// The result depends on the seed, but not on the number of threads
+TEST(TestAccumulation, deterministic) {
+    auto const c = close_test_camera(20, 15);
+    auto const w = default_world();
+    AccumulationBuffer one_thread {20, 15};
+    AccumulationBuffer two_threads {20, 15};
+    AccumulationBuffer other_seed {20, 15};
+    render(c, w, one_thread, ProgressiveOptions {.max_samples = 32}, RenderOptions {1, 4});
+    render(c, w, two_threads, ProgressiveOptions {.max_samples = 32}, RenderOptions {2, 4});
+    render(c, w, other_seed, ProgressiveOptions {.max_samples = 32, .seed = 1}, RenderOptions {1, 4});
+
+    auto differences = 0U;
+    for (auto y = 0U; y < 15; ++y) {
+        for (auto x = 0U; x < 20; ++x) {
+            EXPECT_EQ(one_thread.at(x, y).count(), two_threads.at(x, y).count());
+            EXPECT_EQ(one_thread.at(x, y).mean(), two_threads.at(x, y).mean());
+            if (!(one_thread.at(x, y).mean() == other_seed.at(x, y).mean())) {
+                ++differences;
+            }
+        }
+    }
+    EXPECT_GT(differences, 0U);
+}
+
+// Resolving gives the mean of each pixel, close to its centre colour inside the sphere
+TEST(TestAccumulation, resolve) {
+    auto const c = close_test_camera(20, 15);
+    auto const w = default_world();
+    AccumulationBuffer buffer {20, 15};
+    render(c, w, buffer, ProgressiveOptions {}, RenderOptions {1, 8});
+    auto const image = buffer.resolve();
+    auto const plain = render(c, w);
+
+    EXPECT_EQ(*pixel_at(image, 3, 4), buffer.at(3, 4).mean());
+    EXPECT_EQ(*pixel_at(image, 0, 0), color(0.0, 0.0, 0.0));
+    auto const mean = *pixel_at(image, 10, 7);
+    auto const centre = *pixel_at(plain, 10, 7);
+    EXPECT_NEAR(mean.red(), centre.red(), 0.01);
+    EXPECT_NEAR(mean.green(), centre.green(), 0.01);
+    EXPECT_NEAR(mean.blue(), centre.blue(), 0.01);
+}
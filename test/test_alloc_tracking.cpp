@@ -0,0 +1,102 @@
+// Heap allocation accounting
+//
+// The counting tests only run in builds with RTC_ENABLE_ALLOC_TRACKING.
+
+#include <gtest/gtest.h>
+
+#include <numbers>
+#include <thread>
+
+#include <ray_tracer_challenge/alloc_tracking.h>
+#include <ray_tracer_challenge/camera.h>
+#include <ray_tracer_challenge/patterns.h>
+#include <ray_tracer_challenge/world.h>
+
+using namespace rtc;
+
+constexpr auto pi = std::numbers::pi;
+
+// Without RTC_ENABLE_ALLOC_TRACKING, nothing is counted
+TEST(TestAllocTracking, disabled_counts_nothing) {
+    if constexpr (ALLOC_TRACKING_ENABLED) {
+        GTEST_SKIP() << "built with RTC_ENABLE_ALLOC_TRACKING";
+    }
+    AllocationScope const scope;
+    ::operator delete(::operator new(100));
+    EXPECT_EQ(scope.counts(), AllocationCounts {});
+    EXPECT_EQ(allocation_counts(), AllocationCounts {});
+}
+
+// Every allocation and deallocation is counted, with the bytes allocated
+TEST(TestAllocTracking, counts_allocations) {
+    if constexpr (!ALLOC_TRACKING_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_ALLOC_TRACKING";
+    }
+    AllocationScope const scope {AllocationScope::Threads::this_thread};
+    auto * p = ::operator new(100);
+    auto * q = ::operator new[](28, std::align_val_t {64});
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(q) % 64, 0U);
+    EXPECT_EQ(scope.counts(), (AllocationCounts {.allocations = 2, .bytes = 128}));
+    ::operator delete(p);
+    ::operator delete[](q, std::align_val_t {64});
+    EXPECT_EQ(scope.counts(), (AllocationCounts {.allocations = 2, .deallocations = 2, .bytes = 128}));
+}
+
+// A scope for all threads counts other threads' allocations too
+TEST(TestAllocTracking, other_threads) {
+    if constexpr (!ALLOC_TRACKING_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_ALLOC_TRACKING";
+    }
+    std::thread warm_up {[] {}};  // starting the first thread may allocate
+    warm_up.join();
+
+    AllocationScope const all {AllocationScope::Threads::all};
+    AllocationScope const mine {AllocationScope::Threads::this_thread};
+    std::thread other {[] { ::operator delete(::operator new(1000)); }};
+    other.join();
+    EXPECT_GE(all.counts().allocations, 1U);
+    EXPECT_GE(all.counts().bytes, 1000U);
+    EXPECT_LT(mine.counts().bytes, 1000U);
+}
+
+// Generating a camera ray and shading a point, with a pattern and its noise,
+// allocate nothing
+TEST(TestAllocTracking, shading_allocates_nothing) {
+    if constexpr (!ALLOC_TRACKING_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_ALLOC_TRACKING";
+    }
+    auto c = camera(11, 11, pi / 2.0);
+    c.transform() = view_transform(point(0.0, 0.0, -5.0), point(0.0, 0.0, 0.0), vector(0.0, 1.0, 0.0));
+    auto s = sphere(1);
+    s.material().set_pattern(perturbed_pattern(stripe_pattern(white, black), 0.5, 2));
+    auto const light = point_light(point(-10.0, 10.0, -10.0), color(1.0, 1.0, 1.0));
+
+    AllocationScope const scope {AllocationScope::Threads::this_thread};
+    auto const r = ray_for_pixel(c, 5, 5);
+    auto const colour = lighting(s.material(), s, light, point(0.0, 0.0, -1.0), -r.direction(),
+                                 vector(0.0, 0.0, -1.0), false);
+    EXPECT_EQ(scope.counts().allocations, 0U);
+    EXPECT_NE(colour, black);
+}
+
+// A ray's only allocations are its intersection lists: the list for the
+// world, and one for each shape that it hits
+TEST(TestAllocTracking, traced_ray_budget) {
+    if constexpr (!ALLOC_TRACKING_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_ALLOC_TRACKING";
+    }
+    auto const w = default_world();
+    auto const miss = ray(point(0.0, 5.0, -5.0), vector(0.0, 0.0, 1.0));
+    auto const hit = ray(point(0.0, 0.0, -5.0), vector(0.0, 0.0, 1.0));
+    color_at(w, hit);  // warm up
+
+    AllocationScope const scope {AllocationScope::Threads::this_thread};
+    color_at(w, miss);
+    EXPECT_LE(scope.counts().allocations, 1U);
+
+    AllocationScope const hit_scope {AllocationScope::Threads::this_thread};
+    color_at(w, hit);
+    auto const counts = hit_scope.counts();
+    EXPECT_LE(counts.allocations, 8U);   // primary and shadow rays
+    EXPECT_EQ(counts.deallocations, counts.allocations);
+}
@@ -0,0 +1,110 @@
+// Adaptive supersampling
+
+#include <gtest/gtest.h>
+
+#include <ray_tracer_challenge/antialias.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+namespace {
+
+template <typename Canvas>
+bool same_image(Canvas const & a, Canvas const & b) {
+    for (auto y = 0U; y < a.height(); ++y) {
+        for (auto x = 0U; x < a.width(); ++x) {
+            if (!(*pixel_at(a, x, y) == *pixel_at(b, x, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// Only pixels next to a change of object or colour are refined
+TEST(TestAntialias, refines_edges_only) {
+    auto const w = default_world();
+    auto const c = close_test_camera(40, 30);
+    auto image {canvas(40, 30)};
+    AntialiasStats stats;
+    render(c, w, image, stats, RenderOptions {1, 8});
+
+    EXPECT_EQ(stats.pixels, 40U * 30U);
+    EXPECT_GT(stats.refined_pixels, 0U);
+    EXPECT_LT(stats.refined_fraction(), 0.5);
+    EXPECT_GE(stats.samples, stats.pixels + 16 * stats.refined_pixels);
+
+    // Away from the sphere's outline, nothing changes
+    auto const plain = render(c, w);
+    EXPECT_EQ(*pixel_at(image, 0, 0), *pixel_at(plain, 0, 0));
+    EXPECT_EQ(*pixel_at(image, 20, 15), *pixel_at(plain, 20, 15));
+}
+
+// A refined pixel on the outline is a blend of the sphere and the background
+TEST(TestAntialias, edges_are_blended) {
+    auto const w = default_world();
+    auto const c = close_test_camera(40, 30);
+    auto image {canvas(40, 30)};
+    AntialiasStats stats;
+    render(c, w, image, stats, RenderOptions {1, 8});
+    auto const plain = render(c, w);
+
+    auto blended = 0U;
+    for (auto x = 0U; x < 40; ++x) {
+        auto const before = *pixel_at(plain, x, 15);
+        auto const after = *pixel_at(image, x, 15);
+        if (before == color(0.0, 0.0, 0.0) && after.red() > 0.0) {
+            ++blended;
+        }
+    }
+    EXPECT_GT(blended, 0U);
+}
+
+// A negative threshold refines every pixel
+TEST(TestAntialias, negative_threshold_refines_everything) {
+    auto image {canvas(12, 9)};
+    AntialiasStats stats;
+    render(close_test_camera(12, 9), default_world(), image, stats, RenderOptions {1, 4}, Antialiasing {-1.0, 2});
+    EXPECT_EQ(stats.refined_pixels, 12U * 9U);
+    EXPECT_DOUBLE_EQ(stats.refined_fraction(), 1.0);
+}
+
+// A canvas too small for the camera is reported, and nothing is rendered or counted
+TEST(TestAntialias, canvas_too_small) {
+    auto image {canvas(12, 8)};
+    AntialiasStats stats;
+    EXPECT_FALSE(render(close_test_camera(12, 9), default_world(), image, stats, RenderOptions {1, 4}));
+    EXPECT_EQ(stats.pixels, 0U);
+    EXPECT_EQ(stats.samples, 0U);
+    EXPECT_EQ(*pixel_at(image, 6, 4), color(0.0, 0.0, 0.0));
+}
+
+// With a 1x1 grid, refining traces the same centre ray again, so the image is
+// the same as a plain render
+TEST(TestAntialias, single_sample_grid_matches_plain_render) {
+    auto const w = default_world();
+    auto const c = close_test_camera(23, 13);
+    auto image {canvas(23, 13)};
+    AntialiasStats stats;
+    render(c, w, image, stats, RenderOptions {2, 4}, Antialiasing {0.0, 1});
+    EXPECT_GT(stats.refined_pixels, 0U);
+    EXPECT_TRUE(same_image(image, render(c, w)));
+}
+
+// The result does not depend on how the image is split into tiles
+TEST(TestAntialias, independent_of_tiles) {
+    auto const w = default_world();
+    auto const c = close_test_camera(23, 13);
+    auto small_tiles {canvas(23, 13)};
+    auto one_tile {canvas(23, 13)};
+    AntialiasStats small_stats;
+    AntialiasStats one_stats;
+    render(c, w, small_tiles, small_stats, RenderOptions {2, 4});
+    render(c, w, one_tile, one_stats, RenderOptions {1, 64});
+    EXPECT_TRUE(same_image(small_tiles, one_tile));
+    EXPECT_EQ(small_stats.refined_pixels, one_stats.refined_pixels);
+    EXPECT_GT(small_stats.samples, one_stats.samples);     // the tiles' borders are traced twice
+}
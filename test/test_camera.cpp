@@ -52,6 +52,16 @@ TEST(TestCamera, constructing_ray_through_corner_of_canvas) {
     EXPECT_TRUE(almost_equal(r.direction(), vector(0.66519, 0.33259, -0.66851)));
 }
 
+// A ray through a point within a pixel; a pixel's right edge is the next pixel's left edge
+TEST(TestCamera, constructing_ray_through_point_in_pixel) {
+    auto c = camera(201, 101, pi / 2.0);
+    EXPECT_TRUE(almost_equal(ray_for_pixel(c, 100, 50, 0.5, 0.5).direction(), ray_for_pixel(c, 100, 50).direction()));
+    EXPECT_TRUE(almost_equal(ray_for_pixel(c, 3, 7, 1.0, 0.25).direction(),
+                             ray_for_pixel(c, 4, 7, 0.0, 0.25).direction()));
+    EXPECT_TRUE(almost_equal(ray_for_pixel(c, 0, 0, 0.0, 0.0).direction(),
+                             normalize(vector(1.0, 101.0 / 201.0, -1.0))));
+}
+
 // Constructing a ray when the camera is transformed
 TEST(TestCamera, constructing_ray_when_camera_is_transformed) {
     auto c = camera(201, 101, pi / 2.0);
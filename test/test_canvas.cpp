@@ -82,3 +82,82 @@ TEST(TestCanvas, ppm_terminated_by_newline) {
 
     EXPECT_TRUE(ppm.ends_with('\n'));
 }
+
+// A tiled canvas reads back the pixels written to it
+TEST(TestCanvas, tiled_canvas_pixels) {
+    auto c = tiled_canvas<Color, 4>(10, 7);
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            write_pixel(c, x, y, color(x / 16.0, y / 16.0, 0.0));
+        }
+    }
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            EXPECT_EQ(*pixel_at(c, x, y), color(x / 16.0, y / 16.0, 0.0));
+        }
+    }
+    EXPECT_FALSE(pixel_at(c, 10, 0));
+}
+
+// Each tile of a tiled canvas is contiguous in memory
+TEST(TestCanvas, tiled_canvas_tiles_are_contiguous) {
+    auto c = tiled_canvas<Color, 4>(10, 7);
+    auto const & s = c.storage();
+    EXPECT_EQ(&s.at(0, 1), &s.at(3, 0) + 1);
+    EXPECT_EQ(&s.at(4, 0), &s.at(3, 3) + 1);
+    EXPECT_EQ(&s.at(0, 4), &s.at(11, 3) + 1);
+}
+
+// Linearizing a tiled canvas gives the same image in row order
+TEST(TestCanvas, linearize_tiled_canvas) {
+    auto c = tiled_canvas<Color, 4>(10, 7);
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            write_pixel(c, x, y, color(x / 16.0, y / 16.0, 1.0));
+        }
+    }
+    auto const linear = linearize(c);
+    EXPECT_EQ(linear.width(), 10U);
+    EXPECT_EQ(linear.height(), 7U);
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            EXPECT_EQ(*pixel_at(linear, x, y), color(x / 16.0, y / 16.0, 1.0));
+        }
+    }
+    EXPECT_EQ(ppm_from_canvas(linear), ppm_from_canvas(c));
+}
+
+// Rows of a canvas are spans over its pixels
+TEST(TestCanvas, row_spans) {
+    auto c = canvas(4, 3);
+    auto const row = c.row(1);
+    EXPECT_EQ(row.size(), 4U);
+    row[2] = color(1.0, 0.5, 0.0);
+    EXPECT_EQ(*pixel_at(c, 2, 1), color(1.0, 0.5, 0.0));
+
+    auto const & cc = c;
+    EXPECT_EQ(cc.row(1)[2], color(1.0, 0.5, 0.0));
+}
+
+// A view of part of a canvas addresses pixels relative to its corner
+TEST(TestCanvas, subview) {
+    auto c = canvas(6, 5);
+    auto const v = c.view(2, 1, 3, 2);
+    EXPECT_EQ(v.width(), 3U);
+    EXPECT_EQ(v.height(), 2U);
+    v(0, 0) = color(1.0, 0.0, 0.0);
+    v(2, 1) = color(0.0, 1.0, 0.0);
+    EXPECT_EQ(*pixel_at(c, 2, 1), color(1.0, 0.0, 0.0));
+    EXPECT_EQ(*pixel_at(c, 4, 2), color(0.0, 1.0, 0.0));
+    EXPECT_EQ(v.row(1).data(), &c.row(2)[2]);
+}
+
+// A tile view of a tiled canvas covers one whole tile
+TEST(TestCanvas, tiled_canvas_tile_view) {
+    auto c = tiled_canvas<Color, 4>(10, 7);
+    auto const t = c.storage().tile(5, 6);
+    EXPECT_EQ(t.width(), 4U);
+    EXPECT_EQ(t.height(), 4U);
+    t(1, 2) = color(0.0, 0.0, 1.0);
+    EXPECT_EQ(*pixel_at(c, 5, 6), color(0.0, 0.0, 1.0));
+}
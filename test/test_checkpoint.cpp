@@ -0,0 +1,125 @@
+// Checkpoint and resume
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <ray_tracer_challenge/camera.h>
+#include <ray_tracer_challenge/checkpoint.h>
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/world.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+namespace {
+
+Checkpoint checkpoint_at(TempFile const & file) {
+    return Checkpoint {file.path(), std::chrono::milliseconds {1}, std::nullopt};
+}
+
+} // namespace
+
+// A manifest survives writing and reading back
+TEST(TestCheckpoint, manifest_round_trip) {
+    TempFile file {"round_trip.manifest"};
+    CheckpointManifest m {0x0123456789abcdefULL, 0xfedcba9876543210ULL, 100, 50, 16, {true, false, true, true}};
+    ASSERT_TRUE(write_checkpoint_manifest(file.path(), m));
+    auto const read = read_checkpoint_manifest(file.path());
+    ASSERT_TRUE(read);
+    EXPECT_EQ(read->scene_hash, m.scene_hash);
+    EXPECT_EQ(read->camera_hash, m.camera_hash);
+    EXPECT_EQ(read->width, 100U);
+    EXPECT_EQ(read->height, 50U);
+    EXPECT_EQ(read->tile_size, 16U);
+    EXPECT_EQ(read->done, m.done);
+    EXPECT_FALSE(read_checkpoint_manifest(file.path() + ".missing"));
+}
+
+// Scene and camera hashes change when the scene or camera does
+TEST(TestCheckpoint, hashes) {
+    auto w = default_world();
+    auto const h = scene_hash(w);
+    EXPECT_EQ(scene_hash(default_world()), h);
+    w.objects()[0]->material().set_diffuse(0.5);
+    EXPECT_NE(scene_hash(w), h);
+
+    auto w2 = default_world();
+    w2.objects()[1]->material().set_pattern(stripe_pattern(white, black));
+    EXPECT_NE(scene_hash(w2), h);
+
+    auto const c = test_camera(11, 11);
+    EXPECT_EQ(camera_hash(c), camera_hash(test_camera(11, 11)));
+    EXPECT_NE(camera_hash(c), camera_hash(test_camera(11, 12)));
+}
+
+// A checkpointed render gives the same image as a plain render, and marks every tile done
+TEST(TestCheckpoint, complete_render) {
+    TempFile file {"complete"};
+    auto const w = default_world();
+    auto const c = test_camera(23, 13);
+    auto const image = render(c, w, RenderOptions {2, 4}, checkpoint_at(file));
+    ASSERT_TRUE(image);
+    auto const expected = render(c, w);
+    for (auto y = 0U; y < 13; ++y) {
+        for (auto x = 0U; x < 23; ++x) {
+            EXPECT_EQ(*pixel_at(*image, x, y), Rgb32f(*pixel_at(expected, x, y)));
+        }
+    }
+    auto const manifest = read_checkpoint_manifest(file.path() + ".manifest");
+    ASSERT_TRUE(manifest);
+    EXPECT_EQ(manifest->done.size(), 6U * 4U);
+    EXPECT_EQ(std::count(manifest->done.begin(), manifest->done.end(), true), 24);
+}
+
+// Resuming renders only the tiles the manifest does not mark done
+TEST(TestCheckpoint, resume_skips_done_tiles) {
+    TempFile file {"resume"};
+    auto const w = default_world();
+    auto const c = test_camera(16, 8);
+    auto const options = RenderOptions {1, 4};
+
+    // An interrupted render: tiles 0 and 5 done, holding a marker colour
+    CheckpointManifest m {scene_hash(w), camera_hash(c), 16, 8, 4, std::vector<bool>(8, false)};
+    m.done[0] = m.done[5] = true;
+    {
+        auto partial = mapped_canvas(file.path() + ".pfm", 16, 8);
+        ASSERT_TRUE(partial);
+        partial->write_pixel(1, 1, Rgb32f {9.0f, 9.0f, 9.0f});    // tile 0
+        partial->write_pixel(6, 6, Rgb32f {8.0f, 8.0f, 8.0f});    // tile 5
+        partial->write_pixel(10, 2, Rgb32f {7.0f, 7.0f, 7.0f});   // tile 2, not done
+    }
+    ASSERT_TRUE(write_checkpoint_manifest(file.path() + ".manifest", m));
+
+    auto const image = render(c, w, options, checkpoint_at(file));
+    ASSERT_TRUE(image);
+    auto const expected = render(c, w);
+    EXPECT_EQ(*pixel_at(*image, 1, 1), Rgb32f(9.0f, 9.0f, 9.0f));
+    EXPECT_EQ(*pixel_at(*image, 6, 6), Rgb32f(8.0f, 8.0f, 8.0f));
+    EXPECT_EQ(*pixel_at(*image, 10, 2), Rgb32f(*pixel_at(expected, 10, 2)));
+    EXPECT_EQ(*pixel_at(*image, 15, 7), Rgb32f(*pixel_at(expected, 15, 7)));
+}
+
+// A checkpoint of a different scene is ignored and the render starts again
+TEST(TestCheckpoint, different_scene_restarts) {
+    TempFile file {"restart"};
+    auto const w = default_world();
+    auto const c = test_camera(8, 8);
+
+    CheckpointManifest m {scene_hash(w) + 1, camera_hash(c), 8, 8, 4, std::vector<bool>(4, true)};
+    {
+        auto partial = mapped_canvas(file.path() + ".pfm", 8, 8);
+        ASSERT_TRUE(partial);
+        partial->write_pixel(4, 4, Rgb32f {9.0f, 9.0f, 9.0f});
+    }
+    ASSERT_TRUE(write_checkpoint_manifest(file.path() + ".manifest", m));
+
+    auto const image = render(c, w, RenderOptions {1, 4}, checkpoint_at(file));
+    ASSERT_TRUE(image);
+    EXPECT_EQ(*pixel_at(*image, 4, 4), Rgb32f(*pixel_at(render(c, w), 4, 4)));
+    auto const manifest = read_checkpoint_manifest(file.path() + ".manifest");
+    ASSERT_TRUE(manifest);
+    EXPECT_EQ(manifest->scene_hash, scene_hash(w));
+}
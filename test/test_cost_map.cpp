@@ -0,0 +1,118 @@
+// Per-pixel render cost
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <ray_tracer_challenge/cost_map.h>
+#include <ray_tracer_challenge/world.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+// A cost render gives the same image as a plain render
+TEST(TestCostMap, same_image) {
+    auto const w = default_world();
+    auto const c = test_camera(23, 13);
+    auto image {canvas(23, 13)};
+    CostMap costs {23, 13};
+    render(c, w, image, costs, RenderOptions {2, 8});
+    auto const expected = render(c, w);
+    for (auto y = 0U; y < 13; ++y) {
+        for (auto x = 0U; x < 23; ++x) {
+            EXPECT_EQ(*pixel_at(image, x, y), *pixel_at(expected, x, y));
+        }
+    }
+}
+
+// Every pixel takes some cycles
+TEST(TestCostMap, cycles) {
+    auto const w = default_world();
+    auto image {canvas(11, 11)};
+    CostMap costs {11, 11};
+    render(test_camera(11, 11), w, image, costs, RenderOptions {1, 4}, CostMetric::cycles);
+    for (auto const c : costs.costs()) {
+        EXPECT_GT(c, 0U);
+    }
+}
+
+// A cost map too small for the camera stops the render before it starts
+TEST(TestCostMap, cost_map_too_small) {
+    auto image {canvas(11, 11)};
+    CostMap costs {11, 10};
+    EXPECT_FALSE(render(test_camera(11, 11), default_world(), image, costs, RenderOptions {1, 4}));
+    for (auto const c : costs.costs()) {
+        EXPECT_EQ(c, 0U);
+    }
+    EXPECT_EQ(*pixel_at(image, 5, 5), color(0.0, 0.0, 0.0));
+}
+
+// Counting intersection tests: a pixel that misses tests its primary ray
+// against both spheres, one that hits also tests its shadow ray
+TEST(TestCostMap, intersection_tests) {
+    if constexpr (!STATS_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_STATS";
+    }
+    auto const w = default_world();
+    auto image {canvas(11, 11)};
+    CostMap costs {11, 11};
+    render(test_camera(11, 11), w, image, costs, RenderOptions {2, 4}, CostMetric::intersection_tests);
+    EXPECT_EQ(costs.at(0, 0), 2U);
+    EXPECT_EQ(costs.at(5, 5), 4U);
+}
+
+// sum() totals a rectangle of costs
+TEST(TestCostMap, sum) {
+    CostMap costs {4, 3};
+    for (auto y = 0U; y < 3; ++y) {
+        for (auto x = 0U; x < 4; ++x) {
+            costs.at(x, y) = 10 * y + x;
+        }
+    }
+    EXPECT_EQ(costs.sum(0, 0, 4, 3), 0U + 1 + 2 + 3 + 10 + 11 + 12 + 13 + 20 + 21 + 22 + 23);
+    EXPECT_EQ(costs.sum(1, 1, 3, 3), 11U + 12 + 21 + 22);
+}
+
+// The heatmap runs from the first colour map stop at the lowest cost to the last at full scale
+TEST(TestCostMap, heatmap_colours) {
+    CostMap costs {3, 1};
+    costs.at(0, 0) = 0;
+    costs.at(1, 0) = 50;
+    costs.at(2, 0) = 100;
+    auto const heatmap = cost_heatmap(costs, HeatmapOptions {.clip_percentile = 1.0});
+    EXPECT_EQ(*pixel_at(heatmap, 0, 0), (Rgb8 {0, 0, 4}));
+    EXPECT_EQ(*pixel_at(heatmap, 1, 0), (Rgb8 {188, 55, 84}));
+    EXPECT_EQ(*pixel_at(heatmap, 2, 0), (Rgb8 {252, 255, 164}));
+}
+
+// Outliers above the clip percentile are shown at full scale, without compressing the rest
+TEST(TestCostMap, heatmap_clips_outliers) {
+    CostMap costs {5, 1};
+    for (auto x = 0U; x < 4; ++x) {
+        costs.at(x, 0) = 25 * x;
+    }
+    costs.at(4, 0) = 1'000'000;
+    auto const heatmap = cost_heatmap(costs, HeatmapOptions {.clip_percentile = 0.75});
+    EXPECT_EQ(*pixel_at(heatmap, 3, 0), (Rgb8 {252, 255, 164}));
+    EXPECT_EQ(*pixel_at(heatmap, 4, 0), (Rgb8 {252, 255, 164}));
+    EXPECT_EQ(*pixel_at(heatmap, 2, 0), (Rgb8 {229, 113, 34}));
+}
+
+// Raw costs are written as a greyscale PFM
+TEST(TestCostMap, raw_pfm) {
+    CostMap costs {2, 2};
+    costs.at(0, 0) = 1;
+    costs.at(1, 0) = 2;
+    costs.at(0, 1) = 3;
+    costs.at(1, 1) = 4;
+    std::stringstream ss;
+    write_cost_pfm(ss, costs);
+    EXPECT_EQ(ss.str().substr(0, 12), "Pf\n2 2\n-1.0\n");
+    auto const image = read_pfm(ss);
+    ASSERT_TRUE(image.has_value());
+    EXPECT_EQ(*pixel_at(*image, 0, 0), color(1.0, 1.0, 1.0));
+    EXPECT_EQ(*pixel_at(*image, 1, 0), color(2.0, 2.0, 2.0));
+    EXPECT_EQ(*pixel_at(*image, 0, 1), color(3.0, 3.0, 3.0));
+    EXPECT_EQ(*pixel_at(*image, 1, 1), color(4.0, 4.0, 4.0));
+}
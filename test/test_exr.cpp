@@ -0,0 +1,53 @@
+// OpenEXR image input and output
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/exr.h>
+
+using namespace rtc;
+
+// EXR files start with the magic number and a single-part scanline version field
+TEST(TestExr, magic_and_version) {
+    std::ostringstream os;
+    write_exr(os, canvas(4, 2));
+    auto const exr = os.str();
+    EXPECT_EQ(exr.substr(0, 8), std::string("\x76\x2f\x31\x01\x02\x00\x00\x00", 8));
+    EXPECT_NE(exr.find("channels"), std::string::npos);
+    EXPECT_NE(exr.find("dataWindow"), std::string::npos);
+}
+
+// Writing and reading an EXR preserves values outside [0, 1] to single precision
+TEST(TestExr, round_trip) {
+    auto c = canvas(5, 3);
+    c.write_pixel(0, 0, color(1.5, 0.0, -0.5));
+    c.write_pixel(4, 0, color(0.25, 100.0, 0.125));
+    c.write_pixel(2, 2, color(0.1, 0.2, 0.3));
+    std::stringstream ss;
+    write_exr(ss, c);
+    auto const read = read_exr(ss);
+    ASSERT_TRUE(read);
+    ASSERT_EQ(read->width(), c.width());
+    ASSERT_EQ(read->height(), c.height());
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            EXPECT_TRUE(almost_equal(*read->pixel_at(x, y), *c.pixel_at(x, y)));
+        }
+    }
+}
+
+// Reading anything other than an EXR fails
+TEST(TestExr, read_invalid) {
+    std::istringstream not_exr {"PF\n1 1\n-1\n"};
+    EXPECT_FALSE(read_exr(not_exr));
+
+    std::ostringstream os;
+    write_exr(os, canvas(2, 2));
+    auto const exr = os.str();
+    std::istringstream truncated {exr.substr(0, exr.size() - 4)};
+    EXPECT_FALSE(read_exr(truncated));
+}
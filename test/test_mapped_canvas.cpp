@@ -0,0 +1,129 @@
+// Memory-mapped canvas
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <string>
+
+#include <ray_tracer_challenge/camera.h>
+#include <ray_tracer_challenge/mapped_canvas.h>
+#include <ray_tracer_challenge/pfm.h>
+#include <ray_tracer_challenge/world.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+constexpr auto pi = std::numbers::pi;
+
+// Creating a mapped canvas
+TEST(TestMappedCanvas, create) {
+    TempFile file {"create.pfm"};
+    auto c = mapped_canvas(file.path(), 10, 20);
+    ASSERT_TRUE(c);
+    EXPECT_EQ(c->width(), 10U);
+    EXPECT_EQ(c->height(), 20U);
+    EXPECT_EQ(*c->pixel_at(9, 19), Rgb32f(0.0f, 0.0f, 0.0f));
+    EXPECT_FALSE(c->pixel_at(10, 0));
+}
+
+// The mapped file header keeps the pixel data aligned
+TEST(TestMappedCanvas, header_is_aligned) {
+    TempFile file {"header.pfm"};
+    ASSERT_TRUE(mapped_canvas(file.path(), 10, 20));
+    auto const size = std::filesystem::file_size(file.path());
+    EXPECT_EQ((size - 10 * 20 * sizeof(Rgb32f)) % sizeof(float), 0U);
+}
+
+// The mapped file can be read as a PFM image
+TEST(TestMappedCanvas, readable_as_pfm) {
+    TempFile file {"readable.pfm"};
+    {
+        auto c = mapped_canvas(file.path(), 3, 2);
+        ASSERT_TRUE(c);
+        c->write_pixel(0, 0, Rgb32f(1.5f, 0.5f, -0.25f));
+        c->write_pixel(2, 1, Rgb32f(0.0f, 2.0f, 0.75f));
+        EXPECT_TRUE(c->storage().sync());
+    }
+    std::ifstream is {file.path(), std::ios::binary};
+    auto const image = read_pfm(is);
+    ASSERT_TRUE(image);
+    EXPECT_EQ(image->width(), 3U);
+    EXPECT_EQ(image->height(), 2U);
+    EXPECT_EQ(*image->pixel_at(0, 0), color(1.5, 0.5, -0.25));
+    EXPECT_EQ(*image->pixel_at(2, 1), color(0.0, 2.0, 0.75));
+    EXPECT_EQ(*image->pixel_at(1, 1), color(0.0, 0.0, 0.0));
+}
+
+// Reopening a mapped canvas sees the pixels written earlier
+TEST(TestMappedCanvas, reopen) {
+    TempFile file {"reopen.pfm"};
+    {
+        auto c = mapped_canvas(file.path(), 7, 5);
+        ASSERT_TRUE(c);
+        c->write_pixel(6, 4, Rgb32f(0.25f, 0.5f, 0.75f));
+    }
+    auto c = open_mapped_canvas(file.path());
+    ASSERT_TRUE(c);
+    EXPECT_EQ(c->width(), 7U);
+    EXPECT_EQ(c->height(), 5U);
+    EXPECT_EQ(*c->pixel_at(6, 4), Rgb32f(0.25f, 0.5f, 0.75f));
+}
+
+// Opening a file that is not a little-endian colour PFM fails
+TEST(TestMappedCanvas, open_invalid) {
+    TempFile file {"invalid.pfm"};
+    {
+        std::ofstream os {file.path(), std::ios::binary};
+        os << "PF\n2 2\n1.0\n";
+    }
+    EXPECT_FALSE(open_mapped_canvas(file.path()));
+    EXPECT_FALSE(open_mapped_canvas(file.path() + ".missing"));
+}
+
+// Released rows are reloaded from the file when read again
+TEST(TestMappedCanvas, release_rows) {
+    TempFile file {"release.pfm"};
+    auto c = mapped_canvas(file.path(), 1024, 16);
+    ASSERT_TRUE(c);
+    for (auto y = 0U; y < 16; ++y) {
+        c->write_pixel(y, y, Rgb32f(static_cast<float>(y), 1.0f, 2.0f));
+    }
+    EXPECT_TRUE(c->storage().release_rows(0, 8));
+    EXPECT_TRUE(c->storage().release_rows(8, 100));
+    for (auto y = 0U; y < 16; ++y) {
+        EXPECT_EQ(*c->pixel_at(y, y), Rgb32f(static_cast<float>(y), 1.0f, 2.0f));
+    }
+}
+
+// Rendering into a mapped canvas matches rendering in memory
+TEST(TestMappedCanvas, render) {
+    TempFile file {"render.pfm"};
+    auto w = default_world();
+    auto cam = camera(11, 11, pi / 2.0);
+    cam.transform() = view_transform(point(0.0, 0.0, -5.0), point(0.0, 0.0, 0.0), vector(0.0, 1.0, 0.0));
+
+    auto c = mapped_canvas(file.path(), 11, 11);
+    ASSERT_TRUE(c);
+    render(cam, w, *c);
+    auto const expected = render(cam, w);
+    for (auto y = 0U; y < 11; ++y) {
+        for (auto x = 0U; x < 11; ++x) {
+            EXPECT_EQ(*c->pixel_at(x, y), Rgb32f(*expected.pixel_at(x, y)));
+        }
+    }
+}
+
+// Views of a mapped canvas run top to bottom, though the file is stored bottom to top
+TEST(TestMappedCanvas, view) {
+    TempFile file {"view.pfm"};
+    auto c = mapped_canvas(file.path(), 4, 3);
+    ASSERT_TRUE(c);
+    c->row(0)[1] = Rgb32f(1.0f, 2.0f, 3.0f);
+    c->view(1, 1, 2, 2)(1, 1) = Rgb32f(4.0f, 5.0f, 6.0f);
+    EXPECT_EQ(*c->pixel_at(1, 0), Rgb32f(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(*c->pixel_at(2, 2), Rgb32f(4.0f, 5.0f, 6.0f));
+    EXPECT_EQ(c->view().stride(), -4);
+}
@@ -0,0 +1,132 @@
+// Precomputed Perlin Noise volume
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <ray_tracer_challenge/noise_volume.h>
+#include <ray_tracer_challenge/patterns.h>
+
+using namespace rtc;
+
+// A noise volume reproduces the baked noise at grid points
+TEST(TestNoiseVolume, matches_noise_at_grid_points) {
+    auto const volume = noise_volume(4, 32, 3, 0.8);
+    auto const pn = perlin_noise(4);
+    auto const step = 4.0 / 32;
+    for (auto i : {0, 5, 17, 31}) {
+        for (auto j : {0, 3, 30}) {
+            auto const x = i * step;
+            auto const y = j * step;
+            auto const z = (i + j) % 32 * step;
+            EXPECT_NEAR(volume.sample(x, y, z), pn.octave_perlin(x, y, z, 3, 0.8), 1e-6);
+        }
+    }
+}
+
+// A noise volume approximates the noise between grid points
+TEST(TestNoiseVolume, approximates_noise_between_grid_points) {
+    auto const volume = noise_volume(4, 64, 2, 0.8);
+    auto const pn = perlin_noise(4);
+    for (int i = 0; i < 100; ++i) {
+        auto const x = 0.0371 * i;
+        auto const y = 3.9 - 0.0293 * i;
+        auto const z = 0.0117 * i;
+        EXPECT_NEAR(volume.sample(x, y, z), pn.octave_perlin(x, y, z, 2, 0.8), 0.02);
+    }
+}
+
+// A noise volume tiles seamlessly
+TEST(TestNoiseVolume, tiles_with_period) {
+    auto const volume = noise_volume(2, 16, 2, 0.9);
+    for (auto const v : {0.1, 0.77, 1.3, 1.99}) {
+        EXPECT_NEAR(volume.sample(v, 0.4, 1.1), volume.sample(v + 2.0, 0.4, 1.1), 1e-9);
+        EXPECT_NEAR(volume.sample(v, 0.4, 1.1), volume.sample(v - 4.0, 0.4 + 2.0, 1.1 - 2.0), 1e-9);
+    }
+    // Continuous across the boundary
+    EXPECT_NEAR(volume.sample(1.9999, 0.5, 0.5), volume.sample(2.0, 0.5, 0.5), 1e-3);
+}
+
+// A bounded volume holds the non-repeating noise over its box, faces included
+TEST(TestNoiseVolume, bounded_matches_unrepeated_noise) {
+    auto const volume = NoiseVolume {point(-1.0, 0.5, 2.0), point(3.0, 2.5, 4.0), 16, 3, 0.8};
+    EXPECT_EQ(volume.period(), 0);
+    auto const pn = perlin_noise();
+    for (auto const i : {0, 5, 16}) {
+        for (auto const j : {0, 9, 16}) {
+            auto const x = -1.0 + i * 0.25;
+            auto const y = 0.5 + j * 0.125;
+            auto const z = 2.0 + (i + j) % 17 * 0.125;
+            EXPECT_NEAR(volume.sample(x, y, z), pn.octave_perlin(x, y, z, 3, 0.8), 1e-6);
+        }
+    }
+    EXPECT_TRUE(volume.contains(3.0, 0.5, 4.0));
+    EXPECT_FALSE(volume.contains(3.01, 0.5, 4.0));
+    EXPECT_FALSE(volume.contains(0.0, 0.0, 3.0));
+}
+
+// A perturbed pattern can bake its noise, and copies share the baked volume
+TEST(TestNoiseVolume, perturbed_pattern_bakes_noise) {
+    auto pattern = perturbed_pattern(stripe_pattern(white, black), 1.0, 2, 0.9);
+    EXPECT_EQ(pattern.noise_volume(), nullptr);
+    EXPECT_TRUE(pattern.bake_noise(point(-1.0, -1.0, -1.0), point(1.0, 1.0, 1.0), 32));
+    ASSERT_NE(pattern.noise_volume(), nullptr);
+    EXPECT_EQ(pattern.noise_volume()->num_octaves(), 2);
+
+    auto const copy {pattern};
+    EXPECT_EQ(copy.noise_volume(), pattern.noise_volume());
+
+    auto const c = pattern.pattern_at(point(0.3, 0.0, 0.7));
+    EXPECT_TRUE(c == white || c == black);
+}
+
+// Baking changes only the precision of a pattern's noise: inside the box it is
+// close to the unbaked noise, and outside it is the unbaked noise
+TEST(TestNoiseVolume, baked_pattern_matches_unbaked_noise) {
+    auto const unbaked = perturbed_pattern(stripe_pattern(white, black), 1.0, 3, 0.9);
+    auto baked {unbaked};
+    baked.bake_noise(point(-2.0, -2.0, -2.0), point(2.0, 2.0, 2.0), 128);
+    for (int i = 0; i < 200; ++i) {
+        auto const p = point(-1.97 + 0.0197 * i, 1.9 - 0.0191 * i, -2.0 + 0.0173 * i);
+        auto const expected = unbaked.noise_at(p);
+        auto const actual = baked.noise_at(p);
+        for (auto c = 0U; c < 3; ++c) {
+            EXPECT_NEAR(actual[c], expected[c], 0.02) << i;
+        }
+    }
+    for (auto const & p : {point(2.5, 0.0, 0.0), point(0.0, -7.0, 0.0), point(0.0, 0.0, 9.3)}) {
+        EXPECT_EQ(baked.noise_at(p), unbaked.noise_at(p));
+    }
+}
+
+// Simplex noise is never baked
+TEST(TestNoiseVolume, simplex_pattern_is_not_baked) {
+    auto pattern = perturbed_pattern(stripe_pattern(white, black), 1.0, 2, 0.9, NoiseType::simplex);
+    EXPECT_FALSE(pattern.bake_noise(point(-1.0, -1.0, -1.0), point(1.0, 1.0, 1.0), 16));
+    EXPECT_EQ(pattern.noise_volume(), nullptr);
+}
+
+// A box that is flat or inverted along an axis, or a resolution of 0, bakes nothing
+TEST(TestNoiseVolume, degenerate_box_is_not_baked) {
+    auto pattern = perturbed_pattern(stripe_pattern(white, black), 1.0, 2, 0.9);
+    EXPECT_FALSE(pattern.bake_noise(point(-1.0, 0.0, -1.0), point(1.0, 0.0, 1.0), 16));
+    EXPECT_FALSE(pattern.bake_noise(point(1.0, -1.0, -1.0), point(-1.0, 1.0, 1.0), 16));
+    EXPECT_FALSE(pattern.bake_noise(point(-1.0, -1.0, -1.0), point(1.0, 1.0, 1.0), 0));
+    EXPECT_EQ(pattern.noise_volume(), nullptr);
+}
+
+// A volume built directly over a flat box, or with a resolution of 0, still
+// gives finite noise: the flat axis holds the noise at its one position
+TEST(TestNoiseVolume, degenerate_volume_is_finite) {
+    auto const pn = perlin_noise();
+    auto const flat = NoiseVolume {point(-1.0, 0.5, -1.0), point(1.0, 0.5, 1.0), 8, 2, 0.9};
+    EXPECT_NEAR(flat.sample(0.25, 0.5, -0.5), pn.octave_perlin(0.25, 0.5, -0.5, 2, 0.9), 1e-6);
+    EXPECT_NEAR(flat.sample(0.25, 3.0, -0.5), pn.octave_perlin(0.25, 0.5, -0.5, 2, 0.9), 1e-6);
+
+    auto const coarse = NoiseVolume {point(-1.0, -1.0, -1.0), point(1.0, 1.0, 1.0), 0, 2, 0.9};
+    EXPECT_EQ(coarse.resolution(), 1U);
+    EXPECT_TRUE(std::isfinite(coarse.sample(0.3, -0.2, 0.1)));
+
+    auto const periodic = NoiseVolume {4, 0, 2, 0.9};
+    EXPECT_TRUE(std::isfinite(periodic.sample(5.3, -0.2, 0.1)));
+}
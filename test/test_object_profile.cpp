@@ -0,0 +1,146 @@
+// Per-object cost attribution
+//
+// The profiling tests only run in builds with RTC_ENABLE_PROFILING.
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <ray_tracer_challenge/object_profile.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+namespace {
+
+// The default world, with a perturbed stripe pattern on the outer sphere
+World patterned_world() {
+    auto w = default_world();
+    w.objects()[0]->material().set_pattern(perturbed_pattern(stripe_pattern(white, black), 0.5, 2));
+    return w;
+}
+
+ObjectCost make_cost(std::uint64_t intersection_ns, std::uint64_t shading_ns, std::uint64_t pattern_ns) {
+    return ObjectCost {.nanoseconds = {intersection_ns, shading_ns, pattern_ns}};
+}
+
+} // namespace
+
+// A profiled render gives the same image as a plain render
+TEST(TestObjectProfile, same_image) {
+    auto const w = patterned_world();
+    auto const c = test_camera(23, 13);
+    auto image {canvas(23, 13)};
+    ObjectProfile profile;
+    EXPECT_TRUE(render(c, w, image, profile, RenderOptions {2, 8}));
+    auto const expected = render(c, w);
+    for (auto y = 0U; y < 13; ++y) {
+        for (auto x = 0U; x < 23; ++x) {
+            EXPECT_EQ(*pixel_at(image, x, y), *pixel_at(expected, x, y));
+        }
+    }
+}
+
+// A canvas too small for the camera is reported, and nothing is rendered or recorded
+TEST(TestObjectProfile, canvas_too_small) {
+    auto image {canvas(11, 10)};
+    ObjectProfile profile;
+    EXPECT_FALSE(render(test_camera(11, 11), patterned_world(), image, profile, RenderOptions {1, 4}));
+    EXPECT_TRUE(profile.costs().empty());
+    EXPECT_EQ(*pixel_at(image, 5, 5), color(0.0, 0.0, 0.0));
+}
+
+// Without RTC_ENABLE_PROFILING, nothing is recorded
+TEST(TestObjectProfile, disabled_records_nothing) {
+    if constexpr (PROFILING_ENABLED) {
+        GTEST_SKIP() << "built with RTC_ENABLE_PROFILING";
+    }
+    auto image {canvas(11, 11)};
+    ObjectProfile profile;
+    render(test_camera(11, 11), patterned_world(), image, profile, RenderOptions {1, 4});
+    EXPECT_TRUE(profile.costs().empty());
+}
+
+// Every ray is tested against both spheres; only hits on the outer sphere are
+// shaded, and only it has a pattern
+TEST(TestObjectProfile, calls_per_object) {
+    if constexpr (!PROFILING_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_PROFILING";
+    }
+    auto const w = patterned_world();
+    auto image {canvas(11, 11)};
+    ObjectProfile profile;
+    render(test_camera(11, 11), w, image, profile, RenderOptions {2, 4});
+
+    auto const outer = profile.cost(*w.objects()[0]);
+    auto const inner = profile.cost(*w.objects()[1]);
+    EXPECT_EQ(outer.count(ObjectPhase::intersection), inner.count(ObjectPhase::intersection));
+    EXPECT_GE(outer.count(ObjectPhase::intersection), 121U);
+    EXPECT_GT(outer.count(ObjectPhase::shading), 0U);
+    EXPECT_EQ(outer.count(ObjectPhase::pattern), outer.count(ObjectPhase::shading));
+    EXPECT_GT(outer.ns(ObjectPhase::pattern), 0U);
+    EXPECT_EQ(inner.count(ObjectPhase::shading), 0U);
+    EXPECT_EQ(inner.count(ObjectPhase::pattern), 0U);
+}
+
+// Shading time does not include the shadow rays or pattern lookups it makes
+TEST(TestObjectProfile, nested_time_is_not_counted_twice) {
+    if constexpr (!PROFILING_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_PROFILING";
+    }
+    auto const w = patterned_world();
+    ObjectCosts costs;
+    detail::thread_object_costs = &costs;
+    auto const start = detail::profile_clock_ns();
+    color_at(w, ray(point(0.0, 0.0, -5.0), vector(0.0, 0.0, 1.0)));
+    auto const elapsed = detail::profile_clock_ns() - start;
+    detail::thread_object_costs = nullptr;
+
+    std::uint64_t total {0};
+    for (auto const & [shape, cost] : costs) {
+        total += cost.total_ns();
+    }
+    EXPECT_LE(total, elapsed);
+    EXPECT_EQ(costs[w.objects()[0].get()].count(ObjectPhase::intersection), 2U);  // primary and shadow rays
+}
+
+// Shapes are ranked by their total time
+TEST(TestObjectProfile, ranking) {
+    auto w = default_world();
+    w.add_object(plane());
+    ObjectProfile profile;
+    profile.merge({{w.objects()[0].get(), make_cost(10, 20, 0)},
+                   {w.objects()[2].get(), make_cost(5, 10, 40)}});
+    profile.merge({{w.objects()[0].get(), make_cost(5, 0, 0)}});
+
+    auto const ranked = rank_objects(w, profile);
+    ASSERT_EQ(ranked.size(), 3U);
+    EXPECT_EQ(ranked[0].index, 2U);
+    EXPECT_EQ(ranked[0].cost.total_ns(), 55U);
+    EXPECT_EQ(ranked[1].index, 0U);
+    EXPECT_EQ(ranked[1].cost.ns(ObjectPhase::intersection), 15U);
+    EXPECT_EQ(ranked[2].index, 1U);
+    EXPECT_EQ(ranked[2].cost.total_ns(), 0U);
+}
+
+// The report lists the shapes, most expensive first
+TEST(TestObjectProfile, report) {
+    auto const w = patterned_world();
+    ObjectProfile profile;
+    profile.merge({{w.objects()[0].get(), make_cost(1'000'000, 2'000'000, 1'000'000)},
+                   {w.objects()[1].get(), make_cost(1'000'000, 0, 0)}});
+    std::ostringstream os;
+    write_object_report(os, w, profile);
+
+    std::istringstream lines {os.str()};
+    std::string header, first, second;
+    std::getline(lines, header);
+    std::getline(lines, first);
+    std::getline(lines, second);
+    EXPECT_NE(header.find("total ms"), std::string::npos);
+    EXPECT_EQ(first.substr(0, 39), "1     0       sphere  perturbed        ");
+    EXPECT_NE(first.find("4.00   80.0%"), std::string::npos);
+    EXPECT_EQ(second.substr(0, 39), "2     1       sphere  none             ");
+    EXPECT_NE(second.find("1.00   20.0%"), std::string::npos);
+}
@@ -0,0 +1,81 @@
+// Hardware performance counters
+//
+// Counting tests are skipped where the system provides no counters.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <ray_tracer_challenge/perf_counters.h>
+
+using namespace rtc;
+
+namespace {
+
+// Some work the compiler cannot remove
+std::uint64_t busy_work(unsigned int n) {
+    volatile std::uint64_t total {0};
+    for (auto i = 0U; i < n; ++i) {
+        total = total + i * i;
+    }
+    return total;
+}
+
+} // namespace
+
+// Unavailable counters read as empty, and IPC needs both cycles and instructions
+TEST(TestPerfCounters, ipc) {
+    EXPECT_FALSE(PerfCounts {}.ipc());
+    EXPECT_FALSE((PerfCounts {.cycles = 100}).ipc());
+    EXPECT_FALSE((PerfCounts {.cycles = 0, .instructions = 100}).ipc());
+    EXPECT_DOUBLE_EQ(*(PerfCounts {.cycles = 100, .instructions = 250}).ipc(), 2.5);
+}
+
+// Counters can always be started and stopped, whether or not the system has them
+TEST(TestPerfCounters, start_and_stop) {
+    PerfCounters counters;
+    counters.start();
+    busy_work(1000);
+    auto const counts = counters.stop();
+    if (!counters.available()) {
+        EXPECT_FALSE(counts.cycles);
+        EXPECT_FALSE(counts.instructions);
+        EXPECT_FALSE(counts.cache_misses);
+        EXPECT_FALSE(counts.branch_misses);
+    }
+}
+
+// More work counts more instructions
+TEST(TestPerfCounters, counts_work) {
+    PerfCounters counters;
+    if (!counters.available()) {
+        GTEST_SKIP() << "hardware performance counters are unavailable";
+    }
+    counters.start();
+    busy_work(1000);
+    auto const little = counters.stop();
+    counters.start();
+    busy_work(1000000);
+    auto const lots = counters.stop();
+    ASSERT_TRUE(little.instructions && lots.instructions);
+    EXPECT_GT(*lots.instructions, *little.instructions + 1000000);
+}
+
+// Threads started while counting are counted too, even once they have finished
+TEST(TestPerfCounters, counts_new_threads) {
+    PerfCounters counters;
+    if (!counters.available()) {
+        GTEST_SKIP() << "hardware performance counters are unavailable";
+    }
+    counters.start();
+    std::thread {[] { busy_work(1000000); }}.join();
+    auto const counts = counters.stop();
+    ASSERT_TRUE(counts.instructions);
+    EXPECT_GT(*counts.instructions, 1000000U);
+
+    // and a second start() does not include them again
+    counters.start();
+    auto const again = counters.stop();
+    ASSERT_TRUE(again.instructions);
+    EXPECT_LT(*again.instructions, 1000000U);
+}
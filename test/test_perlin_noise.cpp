@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include <ray_tracer_challenge/perlin_noise.h>
 #include <ray_tracer_challenge/canvas.h>
 
@@ -34,4 +36,95 @@ TEST(TestPerlin, generate_octave_perlin_noise_image) {
     EXPECT_EQ(0.5, pn.perlin(0.0, 0.0, 0.0));
 }
 
+namespace {
+
+// Deterministic spread of sample points, including negative and non-integer coordinates
+struct SamplePoints {
+    explicit SamplePoints(std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            xs.push_back(-7.3 + 0.731 * static_cast<double>(i));
+            ys.push_back(3.1 - 0.417 * static_cast<double>(i));
+            zs.push_back(0.25 + 0.113 * static_cast<double>(i % 13));
+        }
+    }
+
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<double> zs;
+};
+
+template <unsigned int Lanes>
+void expect_batch_matches_scalar(PerlinNoise const & pn, SamplePoints const & s) {
+    std::vector<double> out(s.xs.size());
+    pn.perlin_batch<Lanes>(s.xs.data(), s.ys.data(), s.zs.data(), out.data(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        EXPECT_NEAR(out[i], pn.perlin(s.xs[i], s.ys[i], s.zs[i]), 1e-12) << "index " << i;
+    }
+}
+
+} // namespace
+
+// Batch evaluation matches scalar evaluation, including a partial final block
+TEST(TestPerlin, perlin_batch_matches_perlin) {
+    auto const pn = perlin_noise();
+    SamplePoints const s {37};
+    expect_batch_matches_scalar<4>(pn, s);
+    expect_batch_matches_scalar<8>(pn, s);
+    expect_batch_matches_scalar<16>(pn, s);
+}
+
+// Batch evaluation honours the repeat period
+TEST(TestPerlin, perlin_batch_matches_perlin_with_repeat) {
+    auto const pn = perlin_noise(4);
+    SamplePoints const s {21};
+    expect_batch_matches_scalar<8>(pn, s);
+}
+
+// The single precision path matches the double precision scalar result within tolerance
+TEST(TestPerlin, perlin_batch_float_path) {
+    auto const pn = perlin_noise();
+    SamplePoints const s {50};
+    std::vector<float> xs(s.xs.begin(), s.xs.end());
+    std::vector<float> ys(s.ys.begin(), s.ys.end());
+    std::vector<float> zs(s.zs.begin(), s.zs.end());
+    std::vector<float> out(xs.size());
+    pn.perlin_batch<16>(xs.data(), ys.data(), zs.data(), out.data(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        EXPECT_NEAR(out[i], pn.perlin(xs[i], ys[i], zs[i]), 1e-4) << "index " << i;
+    }
+}
+
+// Batch octave evaluation matches scalar octave evaluation
+TEST(TestPerlin, octave_perlin_batch_matches_octave_perlin) {
+    auto const pn = perlin_noise();
+    SamplePoints const s {29};
+    std::vector<double> out(s.xs.size());
+    pn.octave_perlin_batch<8>(s.xs.data(), s.ys.data(), s.zs.data(), out.data(), out.size(), 4, 0.9);
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        EXPECT_NEAR(out[i], pn.octave_perlin(s.xs[i], s.ys[i], s.zs[i], 4, 0.9), 1e-12) << "index " << i;
+    }
+}
+
+// Fused three-channel evaluation matches three separate octave evaluations, to rounding
+TEST(TestPerlin, octave_perlin3_matches_octave_perlin) {
+    auto const pn = perlin_noise();
+    SamplePoints const s {23};
+    for (std::size_t i = 0; i < s.xs.size(); ++i) {
+        auto const n = pn.octave_perlin3(s.xs[i], s.ys[i], s.zs[i], 4, 0.9);
+        EXPECT_NEAR(n[0], pn.octave_perlin(s.xs[i], s.ys[i], s.zs[i], 4, 0.9), 1e-12);
+        EXPECT_NEAR(n[1], pn.octave_perlin(s.xs[i], s.ys[i], s.zs[i] + 1.0, 4, 0.9), 1e-12);
+        EXPECT_NEAR(n[2], pn.octave_perlin(s.xs[i], s.ys[i], s.zs[i] + 2.0, 4, 0.9), 1e-12);
+    }
+}
 
+// Fused three-channel evaluation honours the repeat period
+TEST(TestPerlin, octave_perlin3_matches_octave_perlin_with_repeat) {
+    auto const pn = perlin_noise(8);
+    SamplePoints const s {23};
+    for (std::size_t i = 0; i < s.xs.size(); ++i) {
+        auto const n = pn.octave_perlin3(s.xs[i], s.ys[i], s.zs[i], 3, 0.7);
+        EXPECT_NEAR(n[0], pn.octave_perlin(s.xs[i], s.ys[i], s.zs[i], 3, 0.7), 1e-12);
+        EXPECT_NEAR(n[1], pn.octave_perlin(s.xs[i], s.ys[i], s.zs[i] + 1.0, 3, 0.7), 1e-12);
+        EXPECT_NEAR(n[2], pn.octave_perlin(s.xs[i], s.ys[i], s.zs[i] + 2.0, 3, 0.7), 1e-12);
+    }
+}
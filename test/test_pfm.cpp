@@ -0,0 +1,89 @@
+// PFM image input and output
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/pfm.h>
+
+using namespace rtc;
+
+namespace {
+
+Canvas<Color> hdr_canvas() {
+    auto c = canvas(3, 2);
+    c.write_pixel(0, 0, color(1.5, 0.0, -0.5));
+    c.write_pixel(1, 0, color(0.25, 100.0, 0.125));
+    c.write_pixel(2, 1, color(0.1, 0.2, 0.3));
+    return c;
+}
+
+} // namespace
+
+// PFM header for a colour image declares little-endian data
+TEST(TestPfm, header) {
+    std::ostringstream os;
+    write_pfm(os, canvas(5, 3));
+    auto const pfm = os.str();
+    EXPECT_EQ(pfm.substr(0, 12), "PF\n5 3\n-1.0\n");
+    EXPECT_EQ(pfm.size(), 12 + 5 * 3 * 3 * 4);
+}
+
+// PFM rows are stored bottom to top
+TEST(TestPfm, rows_bottom_to_top) {
+    auto c = canvas(1, 2);
+    c.write_pixel(0, 1, color(2.0, 3.0, 4.0));
+    std::ostringstream os;
+    write_pfm(os, c);
+    auto const pfm = os.str();
+    float first[3];
+    std::memcpy(first, pfm.data() + pfm.size() - 24, sizeof(first));
+    EXPECT_EQ(first[0], 2.0f);
+    EXPECT_EQ(first[1], 3.0f);
+    EXPECT_EQ(first[2], 4.0f);
+}
+
+// Writing and reading a PFM preserves values outside [0, 1] to single precision
+TEST(TestPfm, round_trip) {
+    auto const c = hdr_canvas();
+    std::stringstream ss;
+    write_pfm(ss, c);
+    auto const read = read_pfm(ss);
+    ASSERT_TRUE(read);
+    ASSERT_EQ(read->width(), c.width());
+    ASSERT_EQ(read->height(), c.height());
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            EXPECT_TRUE(almost_equal(*read->pixel_at(x, y), *c.pixel_at(x, y)));
+        }
+    }
+}
+
+// Reading a big-endian greyscale PFM
+TEST(TestPfm, read_big_endian_greyscale) {
+    std::string pfm {"Pf\n2 1\n1.0\n"};
+    for (float v : {0.5f, 8.0f}) {
+        auto bits = std::bit_cast<std::uint32_t>(v);
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            pfm.push_back(static_cast<char>(bits >> shift));
+        }
+    }
+    std::istringstream is {pfm};
+    auto const read = read_pfm(is);
+    ASSERT_TRUE(read);
+    EXPECT_EQ(*read->pixel_at(0, 0), color(0.5, 0.5, 0.5));
+    EXPECT_EQ(*read->pixel_at(1, 0), color(8.0, 8.0, 8.0));
+}
+
+// Reading malformed or truncated PFM data fails
+TEST(TestPfm, read_invalid) {
+    std::istringstream bad_magic {"P6\n1 1\n-1\n"};
+    EXPECT_FALSE(read_pfm(bad_magic));
+    std::istringstream truncated {"PF\n2 2\n-1\n0123"};
+    EXPECT_FALSE(read_pfm(truncated));
+}
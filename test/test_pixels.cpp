@@ -0,0 +1,124 @@
+// Compact pixel types
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/pfm.h>
+#include <ray_tracer_challenge/pixels.h>
+#include <ray_tracer_challenge/ppm.h>
+
+using namespace rtc;
+
+// Every half-precision value survives a round trip through float
+TEST(TestPixels, half_round_trip_all_values) {
+    for (std::uint32_t h = 0; h <= 0xffff; ++h) {
+        auto const f = detail::half_to_float(static_cast<std::uint16_t>(h));
+        if (std::isnan(f)) {
+            EXPECT_TRUE(std::isnan(detail::half_to_float(detail::float_to_half(f))));
+        } else {
+            EXPECT_EQ(detail::float_to_half(f), h);
+        }
+    }
+}
+
+// Converting to half precision rounds to nearest, ties to even
+TEST(TestPixels, half_rounding) {
+    EXPECT_EQ(detail::float_to_half(1.0f), 0x3c00);
+    EXPECT_EQ(detail::float_to_half(1.0f + 0x1p-11f), 0x3c00);         // tie, round to even
+    EXPECT_EQ(detail::float_to_half(1.0f + 3 * 0x1p-11f), 0x3c02);     // tie, round to even
+    EXPECT_EQ(detail::float_to_half(1.0f + 0x1p-11f + 0x1p-20f), 0x3c01);
+    EXPECT_EQ(detail::float_to_half(65504.0f), 0x7bff);
+    EXPECT_EQ(detail::float_to_half(65519.0f), 0x7bff);
+    EXPECT_EQ(detail::float_to_half(65520.0f), 0x7c00);
+    EXPECT_EQ(detail::float_to_half(-std::numeric_limits<float>::infinity()), 0xfc00);
+    EXPECT_EQ(detail::float_to_half(0x1p-24f), 0x0001);                 // smallest subnormal
+    EXPECT_EQ(detail::float_to_half(0x1p-26f), 0x0000);                 // underflows to zero
+    EXPECT_EQ(detail::float_to_half(-0.0f), 0x8000);
+}
+
+// Half-precision pixels keep about three significant digits
+TEST(TestPixels, rgb16f) {
+    auto const c = color(0.1, 12.5, -3.75);
+    auto const p = Rgb16f {c};
+    EXPECT_NEAR(p.red(), 0.1, 0.1 * 0x1p-11);
+    EXPECT_EQ(p.green(), 12.5);
+    EXPECT_EQ(p.blue(), -3.75);
+}
+
+// Shared-exponent pixels are accurate relative to the brightest channel
+TEST(TestPixels, rgbe) {
+    for (auto const c : {color(1.0, 0.5, 0.25), color(1000.0, 3.0, 0.0), color(0.001, 0.002, 0.0005)}) {
+        auto const p = Rgbe {c};
+        auto const m = std::max({c.red(), c.green(), c.blue()});
+        EXPECT_NEAR(p.red(), c.red(), m / 256);
+        EXPECT_NEAR(p.green(), c.green(), m / 256);
+        EXPECT_NEAR(p.blue(), c.blue(), m / 256);
+    }
+    EXPECT_EQ(Rgbe(color(1.0, 0.0, 0.0)).green(), 0.0);
+    EXPECT_EQ(Rgbe(color(-1.0, 0.5, 0.0)).red(), 0.0);
+    EXPECT_EQ(Rgbe(color(0.0, 0.0, 0.0)), Rgbe {});
+    EXPECT_EQ(Rgbe(color(1.0, 0.5, 0.25)).to_color(), color(1.0, 0.5, 0.25));
+}
+
+// sRGB encoding matches the reference transfer function for every code
+TEST(TestPixels, srgb8_matches_reference) {
+    for (int i = 0; i <= 65536; ++i) {
+        auto const v = i / 65536.0;
+        auto const expected = static_cast<int>(std::lround(detail::srgb_encode(v) * 255.0));
+        auto const p = Srgb8 {color(v, v, v)};
+        EXPECT_EQ(p.r, expected) << "linear value " << v;
+    }
+    for (int i = 0; i < 256; ++i) {
+        auto const code = static_cast<std::uint8_t>(i);
+        auto const p = Srgb8 {code, code, code};
+        EXPECT_EQ(Srgb8 {p.to_color()}, p);
+    }
+}
+
+// sRGB pixels clamp to [0, 1]
+TEST(TestPixels, srgb8_clamps) {
+    EXPECT_EQ(Srgb8(color(-1.0, 2.0, std::nan(""))), Srgb8(0, 255, 0));
+    EXPECT_EQ(Srgb8(color(0.0, 1.0, 0.5)).red(), 0.0);
+    EXPECT_EQ(Srgb8(color(0.0, 1.0, 0.5)).green(), 1.0);
+}
+
+// Bulk conversion gives the same result as converting pixel by pixel
+TEST(TestPixels, convert_pixels) {
+    std::vector<Color> colors;
+    for (int i = 0; i < 100; ++i) {
+        colors.push_back(color(i / 50.0, 1.0 - i / 100.0, i * 0.37));
+    }
+    std::vector<Rgb16f> halves(colors.size());
+    convert_pixels<Rgb16f, Color>(colors, halves);
+    std::vector<Srgb8> srgb(colors.size());
+    convert_pixels<Srgb8, Rgb16f>(halves, srgb);
+    for (std::size_t i = 0; i < colors.size(); ++i) {
+        EXPECT_EQ(halves[i], Rgb16f {colors[i]});
+        EXPECT_EQ(srgb[i], Srgb8 {halves[i].to_color()});
+    }
+}
+
+// The image writers accept canvases of any pixel type
+TEST(TestPixels, writers_accept_compact_canvases) {
+    auto c = canvas(5, 3);
+    c.write_pixel(0, 0, color(1.5, 0.0, 0.0));
+    c.write_pixel(2, 1, color(0.0, 0.5, 0.0));
+    c.write_pixel(4, 2, color(-0.5, 0.0, 1.0));
+
+    auto const expected = ppm_from_canvas(c);
+    EXPECT_EQ(ppm_from_canvas(convert_canvas<Rgb32f>(c)), expected);
+    EXPECT_EQ(ppm_from_canvas(convert_canvas<Rgb16f>(c)), expected);
+
+    std::stringstream ss;
+    write_pfm(ss, convert_canvas<Rgb16f>(c));
+    auto const image = read_pfm(ss);
+    ASSERT_TRUE(image);
+    EXPECT_EQ(*image->pixel_at(0, 0), color(1.5, 0.0, 0.0));
+    EXPECT_EQ(*image->pixel_at(2, 1), color(0.0, 0.5, 0.0));
+}
@@ -0,0 +1,191 @@
+// PNG image output
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/png.h>
+#include <ray_tracer_challenge/thread_pool.h>
+
+using namespace rtc;
+
+namespace {
+
+std::uint32_t get_u32(std::string const & s, std::size_t pos) {
+    return static_cast<std::uint32_t>(static_cast<std::uint8_t>(s[pos])) << 24
+         | static_cast<std::uint32_t>(static_cast<std::uint8_t>(s[pos + 1])) << 16
+         | static_cast<std::uint32_t>(static_cast<std::uint8_t>(s[pos + 2])) << 8
+         | static_cast<std::uint32_t>(static_cast<std::uint8_t>(s[pos + 3]));
+}
+
+struct DecodedPng {
+    unsigned int width {};
+    unsigned int height {};
+    std::vector<std::uint8_t> rgb {};
+    std::vector<std::string> chunk_types {};
+};
+
+// Minimal decoder for the 8-bit RGB, non-interlaced files written by PngWriter.
+// Checks every chunk CRC along the way.
+DecodedPng decode_png(std::string const & png) {
+    DecodedPng result {};
+    EXPECT_EQ(png.substr(0, 8), std::string("\x89PNG\r\n\x1a\n"));
+
+    std::string idat;
+    for (std::size_t pos = 8; pos < png.size();) {
+        auto const length = get_u32(png, pos);
+        auto const type = png.substr(pos + 4, 4);
+        auto const data = png.substr(pos + 8, length);
+        auto const crc = crc32(crc32(0, reinterpret_cast<Bytef const *>(type.data()), 4),
+                               reinterpret_cast<Bytef const *>(data.data()), length);
+        EXPECT_EQ(get_u32(png, pos + 8 + length), crc) << type;
+        result.chunk_types.push_back(type);
+        if (type == "IHDR") {
+            result.width = get_u32(data, 0);
+            result.height = get_u32(data, 4);
+            EXPECT_EQ(data.substr(8), std::string("\x08\x02\x00\x00\x00", 5));
+        } else if (type == "IDAT") {
+            idat += data;
+        }
+        pos += 12 + length;
+    }
+
+    auto const row_size = result.width * 3;
+    std::vector<std::uint8_t> filtered(result.height * (row_size + 1));
+    uLongf size = filtered.size();
+    EXPECT_EQ(uncompress(filtered.data(), &size, reinterpret_cast<Bytef const *>(idat.data()), idat.size()), Z_OK);
+    EXPECT_EQ(size, filtered.size());
+
+    // Undo the filters
+    result.rgb.resize(result.height * row_size);
+    for (auto y = 0U; y < result.height; ++y) {
+        auto const filter = filtered[y * (row_size + 1)];
+        auto const * in = &filtered[y * (row_size + 1) + 1];
+        auto * out = &result.rgb[y * row_size];
+        auto const * prior = y > 0 ? out - row_size : nullptr;
+        for (auto i = 0U; i < row_size; ++i) {
+            int const a = i >= 3 ? out[i - 3] : 0;
+            int const b = prior ? prior[i] : 0;
+            int const c = prior && i >= 3 ? prior[i - 3] : 0;
+            int predictor {0};
+            switch (filter) {
+                case 1: predictor = a; break;
+                case 2: predictor = b; break;
+                case 3: predictor = (a + b) / 2; break;
+                case 4: {
+                    auto const p = a + b - c;
+                    auto const pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                    predictor = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+                    break;
+                }
+                default: break;
+            }
+            out[i] = static_cast<std::uint8_t>(in[i] + predictor);
+        }
+    }
+    return result;
+}
+
+auto test_canvas(unsigned int width, unsigned int height) {
+    auto c = canvas(width, height);
+    for (auto y = 0U; y < height; ++y) {
+        for (auto x = 0U; x < width; ++x) {
+            write_pixel(c, x, y, color(static_cast<double>(x) / width,
+                                       static_cast<double>(y) / height,
+                                       (x * y) % 7 / 6.0));
+        }
+    }
+    return c;
+}
+
+void expect_pixels_match(DecodedPng const & png, Canvas<Color> const & c) {
+    ASSERT_EQ(png.width, c.width());
+    ASSERT_EQ(png.height, c.height());
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            auto const p = *c.pixel_at(x, y);
+            auto const * rgb = &png.rgb[(y * c.width() + x) * 3];
+            ASSERT_EQ(rgb[0], detail::quantize_channel(p.red()));
+            ASSERT_EQ(rgb[1], detail::quantize_channel(p.green()));
+            ASSERT_EQ(rgb[2], detail::quantize_channel(p.blue()));
+        }
+    }
+}
+
+} // namespace
+
+// Writing a canvas as PNG on the calling thread
+TEST(TestPng, write_png) {
+    auto const c = test_canvas(37, 21);
+    std::ostringstream os;
+    EXPECT_TRUE(write_png(os, c));
+
+    auto const png = decode_png(os.str());
+    EXPECT_EQ(png.chunk_types.front(), "IHDR");
+    EXPECT_EQ(png.chunk_types.back(), "IEND");
+    expect_pixels_match(png, c);
+}
+
+// Writing a canvas as PNG with bands compressed on a thread pool
+TEST(TestPng, write_png_on_thread_pool) {
+    auto const c = test_canvas(64, 150);
+    ThreadPool pool {3};
+    std::ostringstream os;
+    EXPECT_TRUE(write_png(os, c, &pool));
+
+    auto const png = decode_png(os.str());
+    EXPECT_GT(png.chunk_types.size(), 4U);  // several IDAT chunks, one per band
+    expect_pixels_match(png, c);
+}
+
+// A band zlib cannot compress (here, for a bad level) makes the write fail
+TEST(TestPng, write_png_reports_compression_failure) {
+    auto const c = test_canvas(16, 40);
+    std::ostringstream os;
+    EXPECT_FALSE(write_png(os, c, 42));
+    ThreadPool pool {2};
+    std::ostringstream pool_os;
+    EXPECT_FALSE(write_png(pool_os, c, &pool, 42));
+}
+
+// Finishing before every row is written fails, and does not end the file
+TEST(TestPng, finish_before_last_row_fails) {
+    std::vector<std::uint8_t> const rgb(8 * 3 * 5, 128);
+    std::ostringstream os;
+    PngWriter writer {os, 8, 12, nullptr, 6, 4};
+    writer.write_rows(rgb.data(), 5);
+    EXPECT_FALSE(writer.finish());
+    EXPECT_FALSE(writer.finish());
+    EXPECT_EQ(os.str().find("IEND"), std::string::npos);
+}
+
+// Rows can be written in bands of any size
+TEST(TestPng, write_rows_in_uneven_bands) {
+    auto const c = test_canvas(10, 9);
+    std::vector<std::uint8_t> rgb;
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            auto const p = *c.pixel_at(x, y);
+            rgb.push_back(detail::quantize_channel(p.red()));
+            rgb.push_back(detail::quantize_channel(p.green()));
+            rgb.push_back(detail::quantize_channel(p.blue()));
+        }
+    }
+
+    ThreadPool pool {2};
+    std::ostringstream os;
+    PngWriter writer {os, c.width(), c.height(), &pool, 9, 2};
+    writer.write_rows(rgb.data(), 4);
+    writer.write_rows(rgb.data() + 4 * 30, 1);
+    writer.write_rows(rgb.data() + 5 * 30, 4);
+    EXPECT_TRUE(writer.finish());
+
+    expect_pixels_match(decode_png(os.str()), c);
+}
@@ -0,0 +1,141 @@
+// Post-processing
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/post_process.h>
+#include <ray_tracer_challenge/ppm.h>
+
+using namespace rtc;
+
+namespace {
+
+// A canvas where every pixel has the same grey value
+Canvas<Rgb32f> flat_canvas(unsigned int width, unsigned int height, float v) {
+    auto c = canvas<Rgb32f>(width, height);
+    for (auto y = 0U; y < height; ++y) {
+        for (auto & p : c.row(y)) {
+            p = Rgb32f {v, v, v};
+        }
+    }
+    return c;
+}
+
+PostProcessOptions linear_options() {
+    PostProcessOptions options;
+    options.srgb = false;
+    return options;
+}
+
+} // namespace
+
+// With no tone mapping or sRGB encoding, values are clamped and rounded
+TEST(TestPostProcess, clamp_and_quantize) {
+    auto c = canvas(4, 1);
+    write_pixel(c, 0, 0, color(0.1, 0.2, 0.35));
+    write_pixel(c, 1, 0, color(-1.0, 2.0, 1.0));
+    write_pixel(c, 2, 0, color(0.0, std::nan(""), 0.999));
+    auto const out = post_process(c, linear_options());
+    for (auto x = 0U; x < c.width(); ++x) {
+        auto const p = *pixel_at(c, x, 0);
+        auto const expected = std::isnan(p.green()) ? Rgb8 {0, 0, 255} : Rgb8 {p};
+        EXPECT_EQ(*pixel_at(out, x, 0), expected) << "pixel " << x;
+    }
+}
+
+// Exposure scales by a power of two
+TEST(TestPostProcess, exposure) {
+    auto options = linear_options();
+    options.exposure = 1.0;
+    auto const out = post_process(flat_canvas(2, 2, 0.25f), options);
+    EXPECT_EQ(*pixel_at(out, 1, 1), Rgb8(128, 128, 128));
+    options.exposure = -2.0;
+    EXPECT_EQ(*pixel_at(post_process(flat_canvas(2, 2, 1.0f), options), 0, 0), Rgb8(64, 64, 64));
+}
+
+// Tone mapping operators compress high values into range
+TEST(TestPostProcess, tone_maps) {
+    auto options = linear_options();
+    options.tone_map = ToneMap::reinhard;
+    EXPECT_EQ(*pixel_at(post_process(flat_canvas(1, 1, 1.0f), options), 0, 0), Rgb8(128, 128, 128));
+    EXPECT_EQ(*pixel_at(post_process(flat_canvas(1, 1, 3.0f), options), 0, 0), Rgb8(191, 191, 191));
+
+    for (auto const op : {ToneMap::reinhard, ToneMap::aces, ToneMap::filmic}) {
+        options.tone_map = op;
+        auto previous = 0;
+        for (auto const v : {0.0f, 0.01f, 0.1f, 0.5f, 1.0f, 2.0f, 10.0f, 1000.0f}) {
+            auto const code = pixel_at(post_process(flat_canvas(1, 1, v), options), 0, 0)->r;
+            EXPECT_GE(code, previous) << "value " << v;
+            previous = code;
+        }
+        EXPECT_EQ(pixel_at(post_process(flat_canvas(1, 1, 0.0f), options), 0, 0)->r, 0);
+        EXPECT_GE(previous, op == ToneMap::reinhard ? 254 : 255);
+    }
+}
+
+// sRGB encoding is within one code of the exact encoding
+TEST(TestPostProcess, srgb) {
+    auto c = canvas<Rgb32f>(1024, 1);
+    for (auto x = 0U; x < c.width(); ++x) {
+        auto const v = static_cast<float>(x) / (c.width() - 1);
+        c.row(0)[x] = Rgb32f {v, v, v};
+    }
+    auto const out = post_process(c);
+    auto exact = 0;
+    for (auto x = 0U; x < c.width(); ++x) {
+        auto const expected = Srgb8 {c.row(0)[x].to_color()}.r;
+        EXPECT_LE(std::abs(out.row(0)[x].r - expected), 1) << "pixel " << x;
+        exact += out.row(0)[x].r == expected;
+    }
+    EXPECT_EQ(out.row(0)[0].r, 0);
+    EXPECT_EQ(out.row(0)[c.width() - 1].r, 255);
+    EXPECT_GE(exact, 1020);
+}
+
+// Ordered dithering preserves the average over each 8x8 block
+TEST(TestPostProcess, dither) {
+    auto options = linear_options();
+    options.dither = true;
+    auto const out = post_process(flat_canvas(8, 8, 10.25f / 255.0f), options);
+    auto sum = 0;
+    for (auto y = 0U; y < 8; ++y) {
+        for (auto const & p : out.row(y)) {
+            EXPECT_TRUE(p.r == 10 || p.r == 11);
+            sum += p.r;
+        }
+    }
+    EXPECT_EQ(sum, 64 * 10 + 16);
+}
+
+// Running on several threads gives the same result as one
+TEST(TestPostProcess, threads) {
+    auto c = canvas<Rgb32f>(37, 53);
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            c.row(y)[x] = Rgb32f {x / 10.0f, y / 20.0f, (x + y) / 90.0f};
+        }
+    }
+    auto options = PostProcessOptions {};
+    options.tone_map = ToneMap::aces;
+    options.dither = true;
+    options.threads = 1;
+    auto const expected = ppm_from_canvas(post_process(c, options));
+    options.threads = 4;
+    EXPECT_EQ(ppm_from_canvas(post_process(c, options)), expected);
+    EXPECT_EQ(ppm_from_canvas(post_process(tiled_canvas<Rgb32f, 8>(37, 53), options)),
+              ppm_from_canvas(post_process(canvas<Rgb32f>(37, 53), options)));
+}
+
+// Image writers output the post-processed codes unchanged
+TEST(TestPostProcess, writers_output_codes) {
+    auto const out = post_process(flat_canvas(2, 1, 0.5f));
+    auto const code = out.row(0)[0].r;
+    EXPECT_EQ(code, 188);
+    auto const ppm = ppm_from_canvas(out, PpmFormat::p6);
+    EXPECT_EQ(static_cast<std::uint8_t>(ppm.back()), code);
+}
@@ -0,0 +1,93 @@
+// PPM image output
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include <ray_tracer_challenge/canvas.h>
+#include <ray_tracer_challenge/ppm.h>
+
+using namespace rtc;
+
+namespace {
+
+auto test_canvas() {
+    auto c = canvas(23, 3);
+    for (auto y = 0U; y < c.height(); ++y) {
+        for (auto x = 0U; x < c.width(); ++x) {
+            write_pixel(c, x, y, color(x / 22.0, 1.0 - y / 2.0, 1.5 - x / 11.0));
+        }
+    }
+    return c;
+}
+
+} // namespace
+
+// Streaming P3 output is the same as ppm_from_canvas
+TEST(TestPpm, write_p3_to_stream) {
+    auto const c = test_canvas();
+    std::ostringstream os;
+    write_ppm(os, c);
+    EXPECT_EQ(os.str(), ppm_from_canvas(c));
+}
+
+// P3 lines are no longer than 70 characters
+TEST(TestPpm, p3_line_length) {
+    auto const ppm = ppm_from_canvas(test_canvas());
+    std::istringstream is {ppm};
+    std::string line;
+    while (std::getline(is, line)) {
+        EXPECT_LE(line.size(), 70U);
+    }
+}
+
+// Binary P6 output
+TEST(TestPpm, write_p6_to_stream) {
+    auto c = canvas(2, 2);
+    write_pixel(c, 0, 0, color(1.5, 0.0, 0.0));
+    write_pixel(c, 1, 0, color(0.0, 0.5, 0.0));
+    write_pixel(c, 0, 1, color(-0.5, 0.0, 1.0));
+    write_pixel(c, 1, 1, color(1.0, 0.8, 0.6));
+    std::ostringstream os;
+    write_ppm(os, c, PpmFormat::p6);
+
+    std::string const expected_header {"P6\n2 2\n255\n"};
+    auto const expected_pixels = std::string {
+        '\xff', '\x00', '\x00',
+        '\x00', '\x80', '\x00',
+        '\x00', '\x00', '\xff',
+        '\xff', '\xcc', '\x99',
+    };
+    EXPECT_EQ(os.str(), expected_header + expected_pixels);
+}
+
+// Output larger than the internal buffer, written to a file descriptor
+TEST(TestPpm, write_p6_to_file_descriptor) {
+    auto c = canvas(200, 150);
+    write_pixel(c, 199, 149, color(1.0, 1.0, 1.0));
+
+    auto * file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    auto const fd = fileno(file);
+    EXPECT_TRUE(write_ppm(fd, c, PpmFormat::p6));
+
+    std::string const header {"P6\n200 150\n255\n"};
+    auto const size = lseek(fd, 0, SEEK_END);
+    EXPECT_EQ(size, static_cast<off_t>(header.size() + 200 * 150 * 3));
+
+    std::string contents(size, '\0');
+    EXPECT_EQ(pread(fd, contents.data(), contents.size(), 0), size);
+    EXPECT_TRUE(contents.starts_with(header));
+    EXPECT_TRUE(contents.ends_with("\xff\xff\xff"));
+    std::fclose(file);
+}
+
+// Writing to an invalid file descriptor fails
+TEST(TestPpm, write_to_bad_file_descriptor) {
+    auto const c = canvas(4, 4);
+    EXPECT_FALSE(write_ppm(-1, c, PpmFormat::p6));
+}
@@ -0,0 +1,88 @@
+// Render progress reporting
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include <ray_tracer_challenge/progress.h>
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/world.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+namespace {
+
+std::vector<RenderProgress> render_with_progress(unsigned int threads, std::chrono::milliseconds interval) {
+    std::vector<RenderProgress> reports;
+    std::mutex reports_mutex;
+    auto image {canvas(64, 48)};
+    render(test_camera(64, 48), default_world(), image,
+           RenderOptions {threads, 8, [&](RenderProgress const & p) {
+               std::lock_guard const lock {reports_mutex};
+               reports.push_back(p);
+           }, interval});
+    return reports;
+}
+
+} // namespace
+
+// The last report is for the finished render, with rates over all of it
+TEST(TestProgress, final_report) {
+    auto const reports = render_with_progress(2, std::chrono::seconds {10});
+    ASSERT_FALSE(reports.empty());
+    auto const & last = reports.back();
+    EXPECT_TRUE(last.done());
+    EXPECT_EQ(last.tiles_done, 48U);
+    EXPECT_EQ(last.tiles_total, 48U);
+    EXPECT_GT(last.elapsed_seconds, 0.0);
+    EXPECT_NEAR(last.rays_per_second, 64 * 48 / last.elapsed_seconds, 1e-6 * last.rays_per_second);
+    EXPECT_GT(last.utilization, 0.0);
+    EXPECT_LE(last.utilization, 1.0);
+    ASSERT_TRUE(last.eta_seconds);
+    EXPECT_EQ(*last.eta_seconds, 0.0);
+}
+
+// Reports come at intervals during the render, never going backwards
+TEST(TestProgress, periodic_reports) {
+    auto const reports = render_with_progress(2, std::chrono::milliseconds {1});
+    ASSERT_FALSE(reports.empty());
+    for (auto i = 1U; i < reports.size(); ++i) {
+        EXPECT_GE(reports[i].tiles_done, reports[i - 1].tiles_done);
+        EXPECT_GE(reports[i].elapsed_seconds, reports[i - 1].elapsed_seconds);
+    }
+    for (auto const & report : reports) {
+        EXPECT_EQ(report.eta_seconds.has_value(), report.tiles_done > 0);
+    }
+    EXPECT_TRUE(reports.back().done());
+}
+
+// Reporting progress does not change the image
+TEST(TestProgress, same_image) {
+    auto const w = default_world();
+    auto const c = test_camera(23, 13);
+    auto const expected = render(c, w);
+    std::ostringstream progress;
+    auto const image = render(c, w, RenderOptions {.threads = 2, .tile_size = 4, .progress = print_progress(progress)});
+    for (auto y = 0U; y < 13; ++y) {
+        for (auto x = 0U; x < 23; ++x) {
+            EXPECT_EQ(*pixel_at(image, x, y), *pixel_at(expected, x, y));
+        }
+    }
+}
+
+// The printed status line is rewritten in place, and ended when the render is done
+TEST(TestProgress, print_progress) {
+    std::ostringstream os;
+    auto const print = print_progress(os);
+    print(RenderProgress {.tiles_done = 107, .tiles_total = 256, .elapsed_seconds = 5.0,
+                          .rays_per_second = 1.25e6, .utilization = 0.97, .eta_seconds = 72.4});
+    EXPECT_EQ(os.str(), "\r  41%  107/256 tiles  1.25 Mrays/s  threads 97% busy  ETA 1:12  ");
+    os.str("");
+    print(RenderProgress {.tiles_done = 256, .tiles_total = 256, .elapsed_seconds = 3725.0,
+                          .rays_per_second = 1.5e6, .utilization = 0.5, .eta_seconds = 0.0});
+    EXPECT_EQ(os.str(), "\r 100%  256/256 tiles  1.50 Mrays/s  threads 50% busy  took 1:02:05\n");
+}
@@ -0,0 +1,78 @@
+// Parallel tiled rendering
+
+#include <gtest/gtest.h>
+
+#include <ray_tracer_challenge/camera.h>
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/world.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+namespace {
+
+template <typename Canvas>
+void expect_same_image(Canvas const & image, rtc::Canvas<Color> const & expected) {
+    ASSERT_EQ(image.width(), expected.width());
+    ASSERT_EQ(image.height(), expected.height());
+    for (auto y = 0U; y < expected.height(); ++y) {
+        for (auto x = 0U; x < expected.width(); ++x) {
+            EXPECT_EQ(*pixel_at(image, x, y), *pixel_at(expected, x, y)) << "pixel " << x << ", " << y;
+        }
+    }
+}
+
+} // namespace
+
+// Rendering tiles on several threads gives the same image as a serial render
+TEST(TestRender, parallel_matches_serial) {
+    auto const w = default_world();
+    auto const c = test_camera(23, 13);
+    auto const expected = render(c, w);
+    for (auto const threads : {1U, 2U, 4U}) {
+        for (auto const tile_size : {1U, 4U, 8U, 32U}) {
+            expect_same_image(render(c, w, RenderOptions {threads, tile_size}), expected);
+        }
+    }
+}
+
+// Rendering on a shared pool gives the same image
+TEST(TestRender, shared_pool) {
+    auto const w = default_world();
+    auto const c = test_camera(23, 13);
+    ThreadPool pool {3};
+    expect_same_image(render(c, w, RenderOptions {.tile_size = 4, .pool = &pool}), render(c, w));
+}
+
+// A canvas too small for the camera is reported and left untouched, not written past
+TEST(TestRender, canvas_too_small) {
+    auto image {canvas(22, 13)};
+    EXPECT_FALSE(render(test_camera(23, 13), default_world(), image, RenderOptions {1, 8}));
+    EXPECT_FALSE(render(test_camera(22, 14), default_world(), image));
+    for (auto y = 0U; y < 13; ++y) {
+        for (auto x = 0U; x < 22; ++x) {
+            EXPECT_EQ(*pixel_at(image, x, y), color(0.0, 0.0, 0.0));
+        }
+    }
+    EXPECT_TRUE(render(test_camera(22, 13), default_world(), image, RenderOptions {1, 8}));
+    EXPECT_TRUE(render(test_camera(21, 12), default_world(), image));
+}
+
+// Rendering into a tiled canvas gives the same image as a serial render
+TEST(TestRender, tiled_canvas) {
+    auto const w = default_world();
+    auto const c = test_camera(23, 13);
+    auto image = tiled_canvas<Color, 8>(23, 13);
+    render(c, w, image, RenderOptions {3, 8});
+    expect_same_image(linearize(image), render(c, w));
+}
+
+// Rendering into a canvas of a compact pixel type
+TEST(TestRender, compact_pixels) {
+    auto const w = default_world();
+    auto const c = test_camera(11, 11);
+    auto image = canvas<Rgb32f>(11, 11);
+    render(c, w, image, RenderOptions {2, 4});
+    EXPECT_TRUE(almost_equal(pixel_at(image, 5, 5)->to_color(), color(0.38066, 0.47583, 0.2855)));
+}
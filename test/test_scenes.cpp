@@ -0,0 +1,95 @@
+// Chapter scene factories
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <sstream>
+#include <string_view>
+
+#include <ray_tracer_challenge/scenes.h>
+
+using namespace rtc;
+
+// Every named scene has a light and at least one object
+TEST(TestScenes, named_scenes_are_lit_and_populated) {
+    ASSERT_EQ(named_scenes().size(), 13U);
+    for (auto const & scene: named_scenes()) {
+        auto const w = scene.make_world();
+        EXPECT_TRUE(w.light().has_value()) << scene.name;
+        EXPECT_FALSE(w.objects().empty()) << scene.name;
+    }
+}
+
+// Scene names are unique
+TEST(TestScenes, names_are_unique) {
+    std::set<std::string_view> names;
+    for (auto const & scene: named_scenes()) {
+        EXPECT_TRUE(names.insert(scene.name).second) << scene.name;
+    }
+}
+
+// Chapter 8 adds one sphere to chapter 7
+TEST(TestScenes, chapter8_extends_chapter7) {
+    EXPECT_EQ(chapter7_world().objects().size(), 6U);
+    EXPECT_EQ(chapter8_world().objects().size(), 7U);
+}
+
+// make_scene() pairs the named world with a chapter camera of the requested size
+TEST(TestScenes, make_scene_by_name) {
+    auto const scene = make_scene("chapter9", 64, 48);
+    ASSERT_TRUE(scene.has_value());
+    EXPECT_EQ(scene->camera.hsize(), 64U);
+    EXPECT_EQ(scene->camera.vsize(), 48U);
+    EXPECT_EQ(scene->camera.transform(), chapter_camera(64, 48).transform());
+    EXPECT_EQ(scene->world.objects().size(), chapter9_world().objects().size());
+}
+
+// An unknown name gives no scene
+TEST(TestScenes, make_scene_unknown_name) {
+    EXPECT_FALSE(make_scene("chapter99", 64, 48).has_value());
+}
+
+// Only plain whole numbers parse
+TEST(TestScenes, parse_unsigned) {
+    EXPECT_EQ(parse_unsigned("640"), 640U);
+    EXPECT_EQ(parse_unsigned("0"), 0U);
+    EXPECT_FALSE(parse_unsigned("").has_value());
+    EXPECT_FALSE(parse_unsigned("-1").has_value());
+    EXPECT_FALSE(parse_unsigned("+1").has_value());
+    EXPECT_FALSE(parse_unsigned("12px").has_value());
+    EXPECT_FALSE(parse_unsigned("99999999999").has_value());
+}
+
+// The scene name is required, and the size defaults to 400x300
+TEST(TestScenes, parse_scene_args_defaults) {
+    std::ostringstream err;
+    char const * const bare[] {"scene_trace"};
+    EXPECT_FALSE(parse_scene_args(1, bare, "[threads]", err).has_value());
+    EXPECT_NE(err.str().find("chapter9"), std::string::npos);
+
+    char const * const named[] {"scene_trace", "chapter9"};
+    auto const args = parse_scene_args(2, named, "[threads]", err);
+    ASSERT_TRUE(args.has_value());
+    EXPECT_EQ(args->name, "chapter9");
+    EXPECT_EQ(args->width, 400U);
+    EXPECT_EQ(args->height, 300U);
+
+    char const * const sized[] {"scene_trace", "chapter9", "64", "48"};
+    auto const sized_args = parse_scene_args(4, sized, "[threads]", err);
+    ASSERT_TRUE(sized_args.has_value());
+    EXPECT_EQ(sized_args->width, 64U);
+    EXPECT_EQ(sized_args->height, 48U);
+}
+
+// Unknown scenes and sizes that are not positive are rejected
+TEST(TestScenes, parse_scene_args_rejects) {
+    std::ostringstream err;
+    char const * const unknown[] {"scene_trace", "chapter99"};
+    EXPECT_FALSE(parse_scene_args(2, unknown, "", err).has_value());
+    for (auto const * size: {"0", "-1", "abc", ""}) {
+        char const * const wide[] {"scene_trace", "chapter9", size};
+        char const * const tall[] {"scene_trace", "chapter9", "64", size};
+        EXPECT_FALSE(parse_scene_args(3, wide, "", err).has_value()) << size;
+        EXPECT_FALSE(parse_scene_args(4, tall, "", err).has_value()) << size;
+    }
+}
@@ -0,0 +1,71 @@
+// Simplex Noise
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <ray_tracer_challenge/simplex_noise.h>
+#include <ray_tracer_challenge/patterns.h>
+
+using namespace rtc;
+
+// Simplex noise is within [0, 1] and uses most of that range
+TEST(TestSimplex, simplex_noise_range) {
+    auto const sn = simplex_noise();
+    double min_v = 1.0;
+    double max_v = 0.0;
+    for (int x = 0; x < 64; ++x) {
+        for (int y = 0; y < 64; ++y) {
+            for (int z = 0; z < 8; ++z) {
+                auto const v = sn.simplex(x * 0.173 - 5.0, y * 0.131 - 4.0, z * 0.377);
+                min_v = std::min(min_v, v);
+                max_v = std::max(max_v, v);
+            }
+        }
+    }
+    EXPECT_GE(min_v, 0.0);
+    EXPECT_LE(max_v, 1.0);
+    EXPECT_LT(min_v, 0.2);
+    EXPECT_GT(max_v, 0.8);
+}
+
+// Octave simplex noise is within [0, 1]
+TEST(TestSimplex, octave_simplex_noise_range) {
+    auto const sn = simplex_noise();
+    for (int i = 0; i < 1000; ++i) {
+        auto const v = sn.octave_simplex(i * 0.0731, 2.0 - i * 0.0119, i * 0.0047, 4, 0.9);
+        EXPECT_GE(v, 0.0);
+        EXPECT_LE(v, 1.0);
+    }
+}
+
+// Simplex noise is continuous: small steps give small changes, including
+// across simplex cell boundaries
+TEST(TestSimplex, simplex_noise_is_continuous) {
+    auto const sn = simplex_noise();
+    constexpr double step {1e-4};
+    double previous = sn.simplex(-3.0, 0.5 - 0.9, 0.25 + 2.1);
+    for (int i = 1; i < 60000; ++i) {
+        auto const x = -3.0 + i * step;
+        auto const v = sn.simplex(x, 0.5 + 0.3 * x, 0.25 - 0.7 * x);
+        EXPECT_LT(std::abs(v - previous), 1e-2) << "x " << x;
+        previous = v;
+    }
+}
+
+// Simplex noise is deterministic and fused channels match separate evaluations
+TEST(TestSimplex, octave_simplex3_matches_octave_simplex) {
+    auto const sn = simplex_noise();
+    auto const n = sn.octave_simplex3(1.3, -0.4, 2.2, 3, 0.8);
+    EXPECT_DOUBLE_EQ(n[0], sn.octave_simplex(1.3, -0.4, 2.2, 3, 0.8));
+    EXPECT_DOUBLE_EQ(n[1], sn.octave_simplex(1.3, -0.4, 3.2, 3, 0.8));
+    EXPECT_DOUBLE_EQ(n[2], sn.octave_simplex(1.3, -0.4, 4.2, 3, 0.8));
+}
+
+// Simplex noise is selectable in a perturbed pattern
+TEST(TestSimplex, perturbed_pattern_with_simplex_noise) {
+    auto const pattern = perturbed_pattern(stripe_pattern(white, black), 1.0, 2, 0.9, NoiseType::simplex);
+    EXPECT_EQ(pattern.noise_type(), NoiseType::simplex);
+    auto const c = pattern.pattern_at(point(0.3, 0.0, 0.7));
+    EXPECT_TRUE(c == white || c == black);
+}
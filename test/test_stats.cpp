@@ -0,0 +1,106 @@
+// Render statistics
+//
+// The counting tests only run in builds with RTC_ENABLE_STATS.
+
+#include <gtest/gtest.h>
+
+#include <numbers>
+
+#include <ray_tracer_challenge/patterns.h>
+#include <ray_tracer_challenge/planes.h>
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/stats.h>
+#include <ray_tracer_challenge/world.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+constexpr auto pi = std::numbers::pi;
+
+namespace {
+
+RenderStats render_stats(Camera const & c, World const & w, unsigned int threads) {
+    auto image = canvas(c.hsize(), c.vsize());
+    return render(c, w, image, RenderOptions {threads, 4}).value();
+}
+
+} // namespace
+
+// Stats add and subtract field by field
+TEST(TestStats, arithmetic) {
+    RenderStats const a {1, 2, 3, 4, 5, 6, 7, 8};
+    RenderStats const b {10, 20, 30, 40, 50, 60, 70, 80};
+    EXPECT_EQ(a + b, (RenderStats {11, 22, 33, 44, 55, 66, 77, 88}));
+    EXPECT_EQ(b - a, (RenderStats {9, 18, 27, 36, 45, 54, 63, 72}));
+}
+
+// Without RTC_ENABLE_STATS, nothing is counted
+TEST(TestStats, disabled_counts_nothing) {
+    if constexpr (STATS_ENABLED) {
+        GTEST_SKIP() << "built with RTC_ENABLE_STATS";
+    }
+    count_stat<&RenderStats::hits>();
+    EXPECT_EQ(thread_render_stats(), RenderStats {});
+    EXPECT_EQ(render_stats(test_camera(11, 11), default_world(), 2), RenderStats {});
+}
+
+// count_stat() adds to this thread's counters
+TEST(TestStats, count_on_this_thread) {
+    if constexpr (!STATS_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_STATS";
+    }
+    auto const before = thread_render_stats();
+    count_stat<&RenderStats::hits>();
+    count_stat<&RenderStats::shadow_rays>(3);
+    auto const delta = thread_render_stats() - before;
+    EXPECT_EQ(delta, (RenderStats {.shadow_rays = 3, .hits = 1}));
+}
+
+// A render of the default world counts one primary ray per pixel, one shadow
+// ray per hit, and tests every ray against both spheres
+TEST(TestStats, default_world_render) {
+    if constexpr (!STATS_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_STATS";
+    }
+    auto const stats = render_stats(test_camera(11, 11), default_world(), 1);
+    EXPECT_EQ(stats.primary_rays, 121U);
+    EXPECT_GT(stats.hits, 0U);
+    EXPECT_LT(stats.hits, 121U);
+    EXPECT_EQ(stats.shadow_rays, stats.hits);
+    EXPECT_EQ(stats.sphere_tests, 2 * (stats.primary_rays + stats.shadow_rays));
+    EXPECT_EQ(stats.plane_tests, 0U);
+    EXPECT_EQ(stats.pattern_evaluations, 0U);
+    EXPECT_GT(stats.matrix_inversions, stats.sphere_tests);
+}
+
+// Totals are the same however many threads render
+TEST(TestStats, independent_of_threads) {
+    if constexpr (!STATS_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_STATS";
+    }
+    auto const c = test_camera(23, 13);
+    auto const w = default_world();
+    auto const expected = render_stats(c, w, 1);
+    EXPECT_EQ(render_stats(c, w, 2), expected);
+    EXPECT_EQ(render_stats(c, w, 4), expected);
+}
+
+// Every hit on a perturbed pattern evaluates the pattern and its noise once
+TEST(TestStats, pattern_and_noise_evaluations) {
+    if constexpr (!STATS_ENABLED) {
+        GTEST_SKIP() << "built without RTC_ENABLE_STATS";
+    }
+    auto w = world();
+    w.add_light(point_light(point(-10.0, 10.0, -10.0), color(1.0, 1.0, 1.0)));
+    auto floor = plane();
+    floor.set_transform(rotation_x(pi / 2.0).then(translation(0.0, 0.0, 1.0)));
+    floor.material().set_pattern(perturbed_pattern(stripe_pattern(white, black), 0.5, 2));
+    w.add_object(floor);
+
+    auto const stats = render_stats(test_camera(11, 11), w, 2);
+    EXPECT_EQ(stats.hits, 121U);
+    EXPECT_EQ(stats.plane_tests, stats.primary_rays + stats.shadow_rays);
+    EXPECT_EQ(stats.pattern_evaluations, stats.hits);
+    EXPECT_EQ(stats.noise_evaluations, stats.hits);
+}
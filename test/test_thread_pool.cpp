@@ -0,0 +1,81 @@
+// Thread pool
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <ray_tracer_challenge/thread_pool.h>
+
+using namespace rtc;
+
+// Submitted tasks run and return their results through futures
+TEST(TestThreadPool, submit_returns_results) {
+    ThreadPool pool {4};
+    EXPECT_EQ(pool.size(), 4U);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(results[i].get(), i * i);
+    }
+}
+
+// Destroying the pool completes all queued tasks
+TEST(TestThreadPool, destructor_completes_queued_tasks) {
+    std::atomic<int> count {0};
+    {
+        ThreadPool pool {2};
+        for (int i = 0; i < 50; ++i) {
+            pool.submit([&count] { ++count; });
+        }
+    }
+    EXPECT_EQ(count, 50);
+}
+
+// parallel_for visits every index once, and with a pool runs on its workers
+// and the calling thread only
+TEST(TestThreadPool, parallel_for_uses_given_pool) {
+    ThreadPool pool {3};
+    std::set<std::thread::id> pool_threads;
+    std::mutex mutex;
+    std::vector<std::future<void>> ids;
+    std::latch all_running {pool.size()};
+    for (auto i = 0U; i < pool.size(); ++i) {
+        ids.push_back(pool.submit([&] {
+            {
+                std::lock_guard const lock {mutex};
+                pool_threads.insert(std::this_thread::get_id());
+            }
+            all_running.arrive_and_wait();     // so each task has a worker of its own
+        }));
+    }
+    for (auto & f : ids) {
+        f.get();
+    }
+    pool_threads.insert(std::this_thread::get_id());
+
+    std::vector<std::atomic<int>> visits(1000);
+    std::set<std::thread::id> used;
+    parallel_for(1000, 0, [&](unsigned int i) {
+        ++visits[i];
+        std::lock_guard const lock {mutex};
+        used.insert(std::this_thread::get_id());
+    }, &pool);
+    for (auto const & v : visits) {
+        EXPECT_EQ(v, 1);
+    }
+    for (auto const & id : used) {
+        EXPECT_EQ(pool_threads.count(id), 1U);
+    }
+    EXPECT_EQ(parallel_threads(0, &pool), 4U);
+    EXPECT_EQ(parallel_threads(9, &pool), 4U);
+    EXPECT_EQ(parallel_threads(2, &pool), 2U);
+}
@@ -0,0 +1,143 @@
+// Tracing of render phases
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <ray_tracer_challenge/render.h>
+#include <ray_tracer_challenge/trace.h>
+#include <ray_tracer_challenge/world.h>
+
+#include "support/support.h"
+
+using namespace rtc;
+
+namespace {
+
+std::vector<TraceEvent> named(std::vector<TraceEvent> const & events, char const * name) {
+    std::vector<TraceEvent> result;
+    std::copy_if(events.begin(), events.end(), std::back_inserter(result),
+                 [&](auto const & e) { return std::strcmp(e.name, name) == 0; });
+    return result;
+}
+
+} // namespace
+
+// Spans are only recorded while a tracer is started
+TEST(TestTrace, only_while_started) {
+    Tracer tracer;
+    { TraceSpan const span {"before", "test"}; }
+    ASSERT_TRUE(tracer.start());
+    { TraceSpan const span {"during", "test", 7}; }
+    tracer.stop();
+    { TraceSpan const span {"after", "test"}; }
+
+    auto const events = tracer.events();
+    ASSERT_EQ(events.size(), 1U);
+    EXPECT_STREQ(events[0].name, "during");
+    EXPECT_STREQ(events[0].category, "test");
+    EXPECT_EQ(events[0].index, 7);
+    EXPECT_EQ(events[0].thread, 0U);
+}
+
+// Only one tracer can be started at a time
+TEST(TestTrace, one_active_tracer) {
+    Tracer first;
+    Tracer second;
+    EXPECT_TRUE(first.start());
+    EXPECT_FALSE(second.start());
+    { TraceSpan const span {"span", "test"}; }
+    first.stop();
+    EXPECT_EQ(first.events().size(), 1U);
+    EXPECT_TRUE(second.events().empty());
+}
+
+// Each thread records into its own buffer
+TEST(TestTrace, threads) {
+    Tracer tracer;
+    tracer.start();
+    { TraceSpan const span {"main", "test"}; }
+    std::thread {[] { TraceSpan const span {"other", "test"}; }}.join();
+    tracer.stop();
+
+    auto const main = named(tracer.events(), "main");
+    auto const other = named(tracer.events(), "other");
+    ASSERT_EQ(main.size(), 1U);
+    ASSERT_EQ(other.size(), 1U);
+    EXPECT_NE(main[0].thread, other[0].thread);
+}
+
+// A full buffer keeps the newest spans
+TEST(TestTrace, ring_buffer) {
+    Tracer tracer {4};
+    tracer.start();
+    for (auto i = 0; i < 10; ++i) {
+        TraceSpan const span {"span", "test", i};
+    }
+    tracer.stop();
+
+    auto const events = tracer.events();
+    ASSERT_EQ(events.size(), 4U);
+    for (auto i = 0U; i < 4; ++i) {
+        EXPECT_EQ(events[i].index, 6 + i);
+    }
+    EXPECT_EQ(tracer.dropped(), 6U);
+}
+
+// A render records one span for the whole render and one for each tile, inside it
+TEST(TestTrace, render_tiles) {
+    Tracer tracer;
+    tracer.start();
+    auto image {canvas(40, 30)};
+    render(test_camera(40, 30), default_world(), image, RenderOptions {2, 16});
+    tracer.stop();
+
+    auto const events = tracer.events();
+    auto const renders = named(events, "render");
+    ASSERT_EQ(renders.size(), 1U);
+    auto tiles = named(events, "tile");
+    ASSERT_EQ(tiles.size(), 6U);
+    std::sort(tiles.begin(), tiles.end(), [](auto const & a, auto const & b) { return a.index < b.index; });
+    for (auto i = 0U; i < tiles.size(); ++i) {
+        EXPECT_EQ(tiles[i].index, i);
+        EXPECT_STREQ(tiles[i].category, "render");
+        EXPECT_GE(tiles[i].start_ns, renders[0].start_ns);
+        EXPECT_LE(tiles[i].start_ns + tiles[i].duration_ns, renders[0].start_ns + renders[0].duration_ns);
+    }
+}
+
+// The Chrome trace has a complete event per span and a name for each thread
+TEST(TestTrace, chrome_trace) {
+    Tracer tracer;
+    tracer.start();
+    { TraceSpan const span {"a \"quoted\" name", "test", 3}; }
+    { TraceSpan const span {"plain", "test"}; }
+    tracer.stop();
+
+    std::stringstream ss;
+    ASSERT_TRUE(tracer.write_chrome_trace(ss));
+    boost::property_tree::ptree trace;
+    boost::property_tree::read_json(ss, trace);
+
+    std::vector<boost::property_tree::ptree> events;
+    for (auto const & [key, event] : trace.get_child("traceEvents")) {
+        events.push_back(event);
+    }
+    ASSERT_EQ(events.size(), 3U);
+    EXPECT_EQ(events[0].get<std::string>("ph"), "M");
+    EXPECT_EQ(events[0].get<std::string>("args.name"), "thread 0");
+    EXPECT_EQ(events[1].get<std::string>("name"), "a \"quoted\" name");
+    EXPECT_EQ(events[1].get<std::string>("ph"), "X");
+    EXPECT_EQ(events[1].get<std::string>("cat"), "test");
+    EXPECT_EQ(events[1].get<int>("tid"), 0);
+    EXPECT_EQ(events[1].get<int>("args.index"), 3);
+    EXPECT_GE(events[1].get<double>("dur"), 0.0);
+    EXPECT_LE(events[1].get<double>("ts"), events[2].get<double>("ts"));
+    EXPECT_FALSE(events[2].get_child_optional("args"));
+}
@@ -106,6 +106,17 @@ TEST(TestWorld, color_with_intersection_behind_ray) {
     EXPECT_EQ(c, inner->material().color());
 }
 
+// A sample is the colour along a ray and the object it hit, if any
+TEST(TestWorld, sample_names_object_hit) {
+    auto w = default_world();
+    auto const hit = sample_at(w, ray(point(0.0, 0.0, -5.0), vector(0.0, 0.0, 1.0)));
+    EXPECT_EQ(hit.object, w.get_object(0));
+    EXPECT_TRUE(almost_equal(hit.color, color(0.38066, 0.47583, 0.2855)));
+    auto const miss = sample_at(w, ray(point(0.0, 0.0, -5.0), vector(0.0, 1.0, 0.0)));
+    EXPECT_EQ(miss.object, nullptr);
+    EXPECT_EQ(miss.color, color(0.0, 0.0, 0.0));
+}
+
 // There is no shadow when nothing is collinear with point and light
 TEST(TestWorld, no_shadow_when_nothing_between_point_and_light) {
     auto w = default_world();